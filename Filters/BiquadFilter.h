@@ -4,7 +4,10 @@
  *      Filename:   BiquadFilter.h
  *
  *   Description:   Biquad Filter Implementation
- *  
+ *                  Templated on the sample type: BiquadFilter is the float
+ *                  filter, BiquadFilterT<double> keeps coefficients and state
+ *                  in double for low cutoffs/high Q (--bench precision)
+ *
  *       Version:   1.0
  *       Created:   12/26/2015
  *
@@ -17,9 +20,15 @@
 #define BIQUADFILTER_H
 
 #include <math.h>
-#include <float.h>
+#include <limits>
+
+#include "SOSCascade.h"
+#include "FastMath.h"
+
+#define BIQUAD_CHUNK            64              // Samples per conversion in processBlock()
 
-class BiquadFilter {
+template <typename Sample>
+class BiquadFilterT {
 public:
     // Filter Type
     enum FILTER {
@@ -36,29 +45,47 @@ public:
     };
 
     // Initializations
-    BiquadFilter() { srate = 44100.f; fc = 0; g = 1; x1 = x2 = y1 = y2 = 0; };
-    BiquadFilter(float _srate) { srate = _srate; fc = 0; g = 1; x1 = x2 = y1 = y2 = 0; };
-    ~BiquadFilter();
+    BiquadFilterT() { srate = 44100.f; fc = 0; g = 1; filter = -1; version = 0; x1 = x2 = y1 = y2 = 0; };
+    BiquadFilterT(Sample _srate) { srate = _srate; fc = 0; g = 1; filter = -1; version = 0; x1 = x2 = y1 = y2 = 0; };
+    ~BiquadFilterT() {};
+
+    // Clears the delay lines (for reuse from a pool)
+    void reset() { x1 = x2 = y1 = y2 = 0; };
 
     // Filter Setup
-    void setFilterGain(float gain) { g = gain; };
-    void setCutoffFrequency(float _fc) { fc = _fc; };
-    void setQ(float _q) { q = _q; };
+    void setFilterGain(Sample gain) { g = gain; version++; };
+    void setCutoffFrequency(Sample _fc) { fc = _fc; };
+    void setQ(Sample _q) { q = _q; };
     void setFilterType(float _filter) { 
         if (filter == _filter) return;
         filter = _filter;
         configureFilter();
     };
 
-    // Configure Filter
+    // Getters
+    int getFilterType() { return filter; };
+    // Bumped whenever the coefficients change
+    unsigned int getVersion() { return version; };
+
+    // Effective response of processBiquad() as one section: (H + 1)/2
+    void getCoefficients(SOSSection *s) {
+        s->b0 = (g*a0 + 1.f)/2.f;
+        s->b1 = (g*a1 + b1)/2.f;
+        s->b2 = (g*a2 + b2)/2.f;
+        s->a1 = b1;
+        s->a2 = b2;
+    };
+
+    // Configure Filter (float: polynomial trig at FM_PRECISE, within a few ulp of libm)
     void configureFilter() {
+        version++;
         switch (filter) {
             case FO_LPF: {
-                float phs = 2.f*M_PI*fc/srate;
+                Sample phs = 2.f*M_PI*fc/srate;
                 // Gamma:
-                float gamma = cosf(phs)/(1+sinf(phs));
+                Sample gamma = sampleCos<FM_PRECISE>(phs)/(1+sampleSin<FM_PRECISE>(phs));
                 // Alpha:
-                float alpha = (1-gamma)/2.f;
+                Sample alpha = (1-gamma)/2.f;
 
                 // Coefs:
                 a0 = alpha;
@@ -69,11 +96,11 @@ public:
                 break;
             }
             case FO_HPF: {
-                float phs = 2.f*M_PI*fc/srate;
+                Sample phs = 2.f*M_PI*fc/srate;
                 // Gamma:
-                float gamma = cosf(phs)/(1+sinf(phs));
+                Sample gamma = sampleCos<FM_PRECISE>(phs)/(1+sampleSin<FM_PRECISE>(phs));
                 // Alpha:
-                float alpha = (1+gamma)/2.f;
+                Sample alpha = (1+gamma)/2.f;
 
                 // Coefs:
                 a0 = alpha;
@@ -84,16 +111,16 @@ public:
                 break;
             }
             case SO_LPF: {
-                float phs = 2.f*M_PI*fc/srate;
-                float d = 1.f/q;
+                Sample phs = 2.f*M_PI*fc/srate;
+                Sample d = 1.f/q;
                 // Beta:
-                float beta_num = 1.f - ((d/2.f)*(sinf(phs)));
-                float beta_den = 1.f + ((d/2.f)*(sinf(phs)));
-                float beta = 0.5f * (beta_num/beta_den);
+                Sample beta_num = 1.f - ((d/2.f)*(sampleSin<FM_PRECISE>(phs)));
+                Sample beta_den = 1.f + ((d/2.f)*(sampleSin<FM_PRECISE>(phs)));
+                Sample beta = 0.5f * (beta_num/beta_den);
                 // Gamma:
-                float gamma = (0.5f + beta) * cosf(phs);
+                Sample gamma = (0.5f + beta) * sampleCos<FM_PRECISE>(phs);
                 // Alpha:
-                float alpha = (0.5f + beta - gamma)/2.f;
+                Sample alpha = (0.5f + beta - gamma)/2.f;
 
                 // Coefs:
                 a0 = alpha;
@@ -104,16 +131,16 @@ public:
                 break;
             }
             case SO_HPF: {
-                float phs = 2.f*M_PI*fc/srate;
-                float d = 1.f/q;
+                Sample phs = 2.f*M_PI*fc/srate;
+                Sample d = 1.f/q;
                 // Beta:
-                float beta_num = 1.f - ((d/2.f)*(sinf(phs)));
-                float beta_den = 1.f + ((d/2.f)*(sinf(phs)));
-                float beta = 0.5f * (beta_num/beta_den);
+                Sample beta_num = 1.f - ((d/2.f)*(sampleSin<FM_PRECISE>(phs)));
+                Sample beta_den = 1.f + ((d/2.f)*(sampleSin<FM_PRECISE>(phs)));
+                Sample beta = 0.5f * (beta_num/beta_den);
                 // Gamma:
-                float gamma = (0.5f + beta) * cosf(phs);
+                Sample gamma = (0.5f + beta) * sampleCos<FM_PRECISE>(phs);
                 // Alpha:
-                float alpha = (0.5f + beta + gamma)/2.f;
+                Sample alpha = (0.5f + beta + gamma)/2.f;
 
                 // Coefs:
                 a0 = alpha;
@@ -124,15 +151,15 @@ public:
                 break;
             }
             case SO_BPF: {
-                float phs = 2.f*M_PI*fc/srate;
+                Sample phs = 2.f*M_PI*fc/srate;
                 // Beta:
-                float beta_num = 1.f - tanf(phs/(2.f*q));
-                float beta_den = 1.f + tanf(phs/(2.f*q));
-                float beta = 0.5f * (beta_num/beta_den);
+                Sample beta_num = 1.f - sampleTan<FM_PRECISE>(phs/(2.f*q));
+                Sample beta_den = 1.f + sampleTan<FM_PRECISE>(phs/(2.f*q));
+                Sample beta = 0.5f * (beta_num/beta_den);
                 // Gamma:
-                float gamma = (0.5f + beta) * cosf(phs);
+                Sample gamma = (0.5f + beta) * sampleCos<FM_PRECISE>(phs);
                 // Alpha:
-                float alpha = (0.5f - beta);
+                Sample alpha = (0.5f - beta);
 
                 // Coefs:
                 a0 = alpha;
@@ -143,15 +170,15 @@ public:
                 break;
             }
             case SO_BSF: {
-                float phs = 2.f*M_PI*fc/srate;
+                Sample phs = 2.f*M_PI*fc/srate;
                 // Beta:
-                float beta_num = 1.f - tanf(phs/(2.f*q));
-                float beta_den = 1.f + tanf(phs/(2.f*q));
-                float beta = 0.5f * (beta_num/beta_den);
+                Sample beta_num = 1.f - sampleTan<FM_PRECISE>(phs/(2.f*q));
+                Sample beta_den = 1.f + sampleTan<FM_PRECISE>(phs/(2.f*q));
+                Sample beta = 0.5f * (beta_num/beta_den);
                 // Gamma:
-                float gamma = (0.5f + beta) * cosf(phs);
+                Sample gamma = (0.5f + beta) * sampleCos<FM_PRECISE>(phs);
                 // Alpha:
-                float alpha = (0.5f + beta);
+                Sample alpha = (0.5f + beta);
 
                 // Coefs:
                 a0 = alpha;
@@ -162,29 +189,29 @@ public:
                 break;
             }
             case SO_LPF_BUTTERS: {
-                float C = 1/(tanf(M_PI*fc/srate));
+                Sample C = 1/(sampleTan<FM_PRECISE>((Sample)(M_PI*fc/srate)));
                 // Coefs:
-                a0 = 1/(1+(sqrt(2)*C)+powf(C,2));
+                a0 = 1/(1+(sqrt(2)*C)+C*C);
                 a1 = 2*a0;
                 a2 = a0;
-                b1 = (2*a0)*(1-powf(C,2));
-                b2 = a0*(1-(sqrt(2)*C)+powf(C,2));
+                b1 = (2*a0)*(1-C*C);
+                b2 = a0*(1-(sqrt(2)*C)+C*C);
                 break;
             }
             case SO_HPF_BUTTERS: {
-                float C = tanf(M_PI*fc/srate);
+                Sample C = sampleTan<FM_PRECISE>((Sample)(M_PI*fc/srate));
                 // Coefs:
-                a0 = 1/(1+(sqrt(2)*C)+powf(C,2));
+                a0 = 1/(1+(sqrt(2)*C)+C*C);
                 a1 = -2*a0;
                 a2 = a0;
-                b1 = (2*a0)*(powf(C,2)-1);
-                b2 = a0*(1-(sqrt(2)*C)+powf(C,2));
+                b1 = (2*a0)*(C*C-1);
+                b2 = a0*(1-(sqrt(2)*C)+C*C);
                 break;
             }
             case SO_BPF_BUTTERS: {
-                float BW = fc/q;                                         
-                float C = 1/(tanf(M_PI*fc*BW/srate));
-                float D = 2*cosf(2*M_PI*fc/srate);
+                Sample BW = fc/q;                                         
+                Sample C = 1/(sampleTan<FM_PRECISE>((Sample)(M_PI*fc*BW/srate)));
+                Sample D = 2*sampleCos<FM_PRECISE>((Sample)(2*M_PI*fc/srate));
                 // Coefs:
                 a0 = 1/(1+C);
                 a1 = 0;
@@ -194,9 +221,9 @@ public:
                 break;
             }
             case SO_BSF_BUTTERS: {
-                float BW = fc/q;                                         
-                float C = tanf(M_PI*fc*BW/srate);
-                float D = 2*cosf(2*M_PI*fc/srate);
+                Sample BW = fc/q;                                         
+                Sample C = sampleTan<FM_PRECISE>((Sample)(M_PI*fc*BW/srate));
+                Sample D = 2*sampleCos<FM_PRECISE>((Sample)(2*M_PI*fc/srate));
                 // Coefs:
                 a0 = 1/(1+C);
                 a1 = -a0*D;
@@ -210,12 +237,11 @@ public:
     };
 
     // Biquad Processing Block
-    float processBiquad(float xn) {
+    Sample processBiquad(Sample xn) {
         // Difference Equation:
-        float yn = (g*((a0*xn) + (a1*x1) + (a2*x2))) - (b1*y1) - (b2*y2);
-        // underflow check
-        if (yn > 0.f && yn < FLT_MIN) yn = 0;
-        if (yn < 0.f && yn > FLT_MIN) yn = 0;
+        Sample yn = (g*((a0*xn) + (a1*x1) + (a2*x2))) - (b1*y1) - (b2*y2);
+        // underflow check (redundant once FTZ is set on the audio thread)
+        if (fabs(yn) < std::numeric_limits<Sample>::min()) yn = 0;
 
         // Takes pop out when no input
         if (xn == 0) { yn = 0; y1 = 0; y2 = 0; }
@@ -228,22 +254,40 @@ public:
         return (yn + xn)/2;
     };
 
+    /*
+     *  Name: processBlock(const float *in, float *out, int n)
+     *  Desc: processBiquad() over a float block (in place is fine), converted
+     *        to and from Sample a chunk at a time
+     */
+    void processBlock(const float *in, float *out, int n) {
+        Sample buf[BIQUAD_CHUNK];
+        for (int start = 0; start < n; start += BIQUAD_CHUNK) {
+            int m = (n - start < BIQUAD_CHUNK) ? n - start : BIQUAD_CHUNK;
+            convertSamples(in + start, buf, m);
+            for (int i = 0; i < m; i++) buf[i] = processBiquad(buf[i]);
+            convertSamples(buf, out + start, m);
+        }
+    };
+
 private:
     // Y delays
-    float y1, y2;
+    Sample y1, y2;
     // x delays
-    float x1, x2;
+    Sample x1, x2;
     // filter gain
-    float g;
+    Sample g;
 
     // coefficients
-    float a0, a1, a2, b1, b2;
+    Sample a0, a1, a2, b1, b2;
 
     // Variables
-    float srate;
-    float fc;
-    float q;
+    Sample srate;
+    Sample fc;
+    Sample q;
     int filter;
+    unsigned int version;
 };
 
+typedef BiquadFilterT<float> BiquadFilter;
+
 #endif // BIQUADFILTER_H
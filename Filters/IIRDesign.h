@@ -0,0 +1,382 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   IIRDesign.h
+ *
+ *   Description:   Arbitrary-order IIR filter designer
+ *                  Butterworth, Chebyshev I/II and elliptic low/high/band pass and
+ *                  band stop designs as second-order sections for SOSCascade.
+ *                  Analog prototype poles/zeros -> frequency transform -> bilinear
+ *                  transform (prewarped) -> sections paired by nearest zeros.
+ *                  Elliptic prototype after Orfanidis, "Lecture Notes on Elliptic
+ *                  Filter Design" (Landen transformations).
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef IIRDESIGN_H
+#define IIRDESIGN_H
+
+#include <math.h>
+#include <complex>
+#include <vector>
+#include <algorithm>
+
+#include "SOSCascade.h"
+
+typedef std::complex<double> cplx;
+
+class IIRDesign {
+public:
+    // Filter Family
+    enum FAMILY {
+        BUTTERWORTH = 0,    // Maximally flat
+        CHEBYSHEV1 = 1,     // Passband ripple
+        CHEBYSHEV2 = 2,     // Stopband ripple, edges are stopband edges
+        ELLIPTIC = 3,       // Ripple in both, steepest for an order
+    };
+
+    // Response Type
+    enum RESPONSE {
+        LOWPASS = 0,
+        HIGHPASS = 1,
+        BANDPASS = 2,
+        BANDSTOP = 3,
+    };
+
+    /*
+     *  Name: design()
+     *  Desc: Designs into sos, returns the number of sections (0 on bad arguments)
+     *        order:  prototype order, band designs come out twice as high
+     *        f1, f2: cutoff (f2 unused), or band edges in Hz
+     *        ripple: passband ripple in dB (Chebyshev I, elliptic)
+     *        atten:  stopband attenuation in dB (Chebyshev II, elliptic)
+     *        sos:    float sections for SOSCascade, double for SOSCascadeT<double>
+     */
+    template <typename Sample>
+    static int design(int family, int response, int order, double srate, double f1, double f2,
+            double ripple, double atten, SOSSectionT<Sample> *sos, int maxSections) {
+        bool band = (response == BANDPASS || response == BANDSTOP);
+        if (order < 1 || f1 <= 0 || f1 >= srate/2) return 0;
+        if (band && (f2 <= f1 || f2 >= srate/2)) return 0;
+        if ((band ? 2*order : order) > 2*maxSections) return 0;
+
+        ZPK f;
+        switch (family) {
+            case BUTTERWORTH: butterworth(order, &f); break;
+            case CHEBYSHEV1: chebyshev1(order, ripple, &f); break;
+            case CHEBYSHEV2: chebyshev2(order, atten, &f); break;
+            case ELLIPTIC: elliptic(order, ripple, atten, &f); break;
+            default: return 0;
+        }
+
+        // Prewarped edges
+        double w1 = 2*srate*tan(M_PI*f1/srate);
+        double w2 = band ? 2*srate*tan(M_PI*f2/srate) : 0;
+        switch (response) {
+            case LOWPASS: toLowpass(&f, w1); break;
+            case HIGHPASS: toHighpass(&f, w1); break;
+            case BANDPASS: toBandpass(&f, sqrt(w1*w2), w2 - w1); break;
+            case BANDSTOP: toBandstop(&f, sqrt(w1*w2), w2 - w1); break;
+            default: return 0;
+        }
+
+        bilinear(&f, srate);
+        return toSections(&f, sos);
+    };
+
+    /*
+     *  Name: response()
+     *  Desc: Complex response of a cascade at freq (Hz)
+     */
+    template <typename Sample>
+    static cplx response(const SOSSectionT<Sample> *sos, int n, double freq, double srate) {
+        cplx z1 = std::polar(1.0, -2*M_PI*freq/srate);
+        cplx z2 = z1*z1;
+        cplx h = 1;
+        for (int i = 0; i < n; i++)
+            h *= ((double)sos[i].b0 + (double)sos[i].b1*z1 + (double)sos[i].b2*z2) /
+                 (1.0 + (double)sos[i].a1*z1 + (double)sos[i].a2*z2);
+        return h;
+    };
+
+private:
+    // Poles, zeros and gain
+    typedef struct {
+        std::vector<cplx> z, p;
+        double k;
+    } ZPK;
+
+    /*
+     *  Analog prototypes, edge at 1 rad/s
+     */
+    static void butterworth(int n, ZPK *f) {
+        for (int i = 0; i < n; i++) f->p.push_back(std::polar(1.0, M_PI*(2*i + 1 + n)/(2*n)));
+        f->k = 1;
+    };
+
+    static void chebyshev1(int n, double rp, ZPK *f) {
+        double eps = sqrt(pow(10, rp/10) - 1);
+        double mu = asinh(1/eps)/n;
+        cplx prod = 1;
+        for (int i = 0; i < n; i++) {
+            double theta = M_PI*(2*i + 1)/(2*n);
+            cplx p(-sinh(mu)*sin(theta), cosh(mu)*cos(theta));
+            f->p.push_back(p);
+            prod *= -p;
+        }
+        f->k = prod.real();
+        if (n % 2 == 0) f->k /= sqrt(1 + eps*eps);
+    };
+
+    static void chebyshev2(int n, double rs, ZPK *f) {
+        double de = 1/sqrt(pow(10, rs/10) - 1);
+        double mu = asinh(1/de)/n;
+        cplx pz = 1, pp = 1;
+        for (int m = -n + 1; m < n; m += 2) {
+            if (m != 0) {
+                cplx z(0, 1/sin(m*M_PI/(2*n)));
+                f->z.push_back(z);
+                pz *= -z;
+            }
+            cplx p = -std::polar(1.0, M_PI*m/(2*n));
+            p = 1.0/cplx(sinh(mu)*p.real(), cosh(mu)*p.imag());
+            f->p.push_back(p);
+            pp *= -p;
+        }
+        f->k = (pp/pz).real();
+    };
+
+    static void elliptic(int n, double rp, double rs, ZPK *f) {
+        double ep = sqrt(pow(10, rp/10) - 1);
+        double es = sqrt(pow(10, rs/10) - 1);
+        double k1 = ep/es;
+        double k = ellipdeg(n, k1);
+        double v0 = (cplx(0, -1)*asne(cplx(0, 1/ep), k1)/(double)n).real();
+
+        cplx pz = 1, pp = 1;
+        for (int i = 1; i <= n/2; i++) {
+            double u = (2.0*i - 1)/n;
+            cplx z = cplx(0, 1)/(k*cde(u, k));
+            cplx p = cplx(0, 1)*cde(cplx(u, -v0), k);
+            f->z.push_back(z); f->z.push_back(std::conj(z));
+            f->p.push_back(p); f->p.push_back(std::conj(p));
+            pz *= std::norm(z);
+            pp *= std::norm(p);
+        }
+        if (n % 2) {
+            cplx p0 = cplx(0, 1)*sne(cplx(0, v0), k);
+            p0 = cplx(p0.real(), 0);
+            f->p.push_back(p0);
+            pp *= -p0;
+        }
+
+        // Unity (odd) or -ripple (even) at DC
+        f->k = (pp/pz).real();
+        if (n % 2 == 0) f->k /= sqrt(1 + ep*ep);
+    };
+
+    /*
+     *  Elliptic helpers: Landen moduli, cd/sn and inverses with u in units of K
+     */
+    static int landen(double k, double *v) {
+        int m = 0;
+        while (k > 1e-15 && m < 16) {
+            k = pow(k/(1 + sqrt(1 - k*k)), 2);
+            v[m++] = k;
+        }
+        return m;
+    };
+
+    static double ellipK(double k) {
+        double v[16];
+        int m = landen(k, v);
+        double K = M_PI/2;
+        for (int i = 0; i < m; i++) K *= 1 + v[i];
+        return K;
+    };
+
+    static cplx cde(cplx u, double k) {
+        double v[16];
+        int m = landen(k, v);
+        cplx w = std::cos(u*M_PI/2.0);
+        for (int i = m - 1; i >= 0; i--) w = (1 + v[i])*w/(1.0 + v[i]*w*w);
+        return w;
+    };
+
+    static cplx sne(cplx u, double k) {
+        double v[16];
+        int m = landen(k, v);
+        cplx w = std::sin(u*M_PI/2.0);
+        for (int i = m - 1; i >= 0; i--) w = (1 + v[i])*w/(1.0 + v[i]*w*w);
+        return w;
+    };
+
+    static double srem(double x, double y) { return x - y*round(x/y); };
+
+    static cplx acde(cplx w, double k) {
+        double v[16];
+        int m = landen(k, v);
+        for (int i = 0; i < m; i++) {
+            double v1 = (i == 0) ? k : v[i - 1];
+            w = w/(1.0 + std::sqrt(1.0 - w*w*v1*v1))*2.0/(1 + v[i]);
+        }
+        cplx u = 2/M_PI*std::acos(w);
+
+        double R = ellipK(sqrt(1 - k*k))/ellipK(k);
+        return cplx(srem(u.real(), 4), srem(u.imag(), 2*R));
+    };
+
+    static cplx asne(cplx w, double k) { return 1.0 - acde(w, k); };
+
+    // Modulus k that meets order n for the given k1 (degree equation)
+    static double ellipdeg(int n, double k1) {
+        double k1p = sqrt(1 - k1*k1);
+        double kp = pow(k1p, n);
+        for (int i = 1; i <= n/2; i++) kp *= pow(sne((2.0*i - 1)/n, k1p).real(), 4);
+        return sqrt(1 - kp*kp);
+    };
+
+    /*
+     *  Frequency transforms (analog)
+     */
+    static void toLowpass(ZPK *f, double w) {
+        for (unsigned int i = 0; i < f->z.size(); i++) f->z[i] *= w;
+        for (unsigned int i = 0; i < f->p.size(); i++) f->p[i] *= w;
+        f->k *= pow(w, (double)(f->p.size() - f->z.size()));
+    };
+
+    static void toHighpass(ZPK *f, double w) {
+        int degree = f->p.size() - f->z.size();
+        cplx pz = 1, pp = 1;
+        for (unsigned int i = 0; i < f->z.size(); i++) { pz *= -f->z[i]; f->z[i] = w/f->z[i]; }
+        for (unsigned int i = 0; i < f->p.size(); i++) { pp *= -f->p[i]; f->p[i] = w/f->p[i]; }
+        for (int i = 0; i < degree; i++) f->z.push_back(0);
+        f->k *= (pz/pp).real();
+    };
+
+    static void toBandpass(ZPK *f, double w0, double bw) {
+        int degree = f->p.size() - f->z.size();
+        f->z = bandRoots(f->z, bw/2, w0, false);
+        f->p = bandRoots(f->p, bw/2, w0, false);
+        for (int i = 0; i < degree; i++) f->z.push_back(0);
+        f->k *= pow(bw, (double)degree);
+    };
+
+    static void toBandstop(ZPK *f, double w0, double bw) {
+        int degree = f->p.size() - f->z.size();
+        cplx pz = 1, pp = 1;
+        for (unsigned int i = 0; i < f->z.size(); i++) pz *= -f->z[i];
+        for (unsigned int i = 0; i < f->p.size(); i++) pp *= -f->p[i];
+        f->z = bandRoots(f->z, bw/2, w0, true);
+        f->p = bandRoots(f->p, bw/2, w0, true);
+        for (int i = 0; i < degree; i++) {
+            f->z.push_back(cplx(0, w0));
+            f->z.push_back(cplx(0, -w0));
+        }
+        f->k *= (pz/pp).real();
+    };
+
+    // Each root r maps to the two roots of s^2 - a*s + w0^2 (a = h*r, or h/r when inverted)
+    static std::vector<cplx> bandRoots(const std::vector<cplx> &r, double h, double w0, bool invert) {
+        std::vector<cplx> out;
+        for (unsigned int i = 0; i < r.size(); i++) {
+            cplx a = invert ? h/r[i] : h*r[i];
+            cplx d = std::sqrt(a*a - w0*w0);
+            out.push_back(a + d);
+            out.push_back(a - d);
+        }
+        return out;
+    };
+
+    // Analog -> digital, zeros at infinity land on Nyquist
+    static void bilinear(ZPK *f, double srate) {
+        double fs2 = 2*srate;
+        int degree = f->p.size() - f->z.size();
+        cplx pz = 1, pp = 1;
+        for (unsigned int i = 0; i < f->z.size(); i++) { pz *= fs2 - f->z[i]; f->z[i] = (fs2 + f->z[i])/(fs2 - f->z[i]); }
+        for (unsigned int i = 0; i < f->p.size(); i++) { pp *= fs2 - f->p[i]; f->p[i] = (fs2 + f->p[i])/(fs2 - f->p[i]); }
+        for (int i = 0; i < degree; i++) f->z.push_back(-1);
+        f->k *= (pz/pp).real();
+    };
+
+    /*
+     *  Sections: conjugate pairs (or two real roots) per section, each pole pair
+     *  takes its nearest zeros, poles nearest the unit circle run last
+     */
+    typedef struct {
+        cplx r1, r2;
+        bool single;
+    } RootPair;
+
+    static std::vector<RootPair> pairRoots(const std::vector<cplx> &roots) {
+        std::vector<RootPair> pairs;
+        std::vector<double> reals;
+        for (unsigned int i = 0; i < roots.size(); i++) {
+            if (fabs(roots[i].imag()) <= 1e-9*std::max(1.0, std::abs(roots[i]))) reals.push_back(roots[i].real());
+            else if (roots[i].imag() > 0) {
+                RootPair rp = { roots[i], std::conj(roots[i]), false };
+                pairs.push_back(rp);
+            }
+        }
+        std::sort(reals.begin(), reals.end());
+        for (unsigned int i = 0; i < reals.size(); i += 2) {
+            bool single = (i + 1 == reals.size());
+            RootPair rp = { reals[i], single ? 0 : reals[i + 1], single };
+            pairs.push_back(rp);
+        }
+        return pairs;
+    };
+
+    static bool closerToCircle(const RootPair &a, const RootPair &b) {
+        return std::max(std::abs(a.r1), std::abs(a.r2)) > std::max(std::abs(b.r1), std::abs(b.r2));
+    };
+
+    template <typename Sample>
+    static int toSections(ZPK *f, SOSSectionT<Sample> *sos) {
+        std::vector<RootPair> poles = pairRoots(f->p);
+        std::vector<RootPair> zeros = pairRoots(f->z);
+        std::sort(poles.begin(), poles.end(), closerToCircle);
+
+        int n = poles.size();
+        std::vector<RootPair> matched(n);
+        for (int i = 0; i < n; i++) {
+            int best = -1;
+            double bestDist = 0;
+            for (unsigned int j = 0; j < zeros.size(); j++) {
+                if (zeros[j].single != poles[i].single) continue;
+                double d = std::min(std::abs(zeros[j].r1 - poles[i].r1), std::abs(zeros[j].r2 - poles[i].r1));
+                if (best < 0 || d < bestDist) { best = j; bestDist = d; }
+            }
+            matched[i] = zeros[best];
+            zeros.erase(zeros.begin() + best);
+        }
+
+        // Gain spread evenly, a high order's overall gain underflows a float
+        double g = pow(fabs(f->k), 1.0/n);
+
+        // Reverse: least resonant section first
+        for (int i = 0; i < n; i++) {
+            const RootPair &p = poles[n - 1 - i];
+            const RootPair &z = matched[n - 1 - i];
+            SOSSectionT<Sample> s;
+            s.b0 = 1;
+            s.b1 = z.single ? -z.r1.real() : -(z.r1 + z.r2).real();
+            s.b2 = z.single ? 0 : (z.r1*z.r2).real();
+            s.a1 = p.single ? -p.r1.real() : -(p.r1 + p.r2).real();
+            s.a2 = p.single ? 0 : (p.r1*p.r2).real();
+            double gi = (i == 0 && f->k < 0) ? -g : g;
+            s.b0 = gi*s.b0; s.b1 = gi*s.b1; s.b2 = gi*s.b2;
+            sos[i] = s;
+        }
+        return n;
+    };
+};
+
+#endif // IIRDESIGN_H
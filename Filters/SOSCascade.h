@@ -0,0 +1,124 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   SOSCascade.h
+ *
+ *   Description:   Cascade of second-order sections
+ *                  Runs a whole block through one section at a time so each
+ *                  section's coefficients and state stay in registers, in
+ *                  direct form I or transposed direct form II.
+ *                  Templated on the sample type: SOSCascade is the float cascade,
+ *                  good to about order 8 for narrow low cutoffs; past that use
+ *                  SOSCascadeT<double> with double sections (--bench iir)
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef SOSCASCADE_H
+#define SOSCASCADE_H
+
+#include <string.h>
+
+#define SOS_MAX_SECTIONS        16          // Order 32 for low/high pass
+
+// One second-order section, a0 normalized to 1
+template <typename Sample>
+struct SOSSectionT {
+    Sample b0, b1, b2;
+    Sample a1, a2;
+};
+
+template <typename Sample>
+class SOSCascadeT {
+public:
+    // Section Structure
+    enum FORM {
+        DF1 = 0,            // Direct form I: x1 x2 y1 y2
+        TDF2 = 1,           // Transposed direct form II: s1 s2, better in float
+    };
+
+    // Initializations
+    SOSCascadeT() { count = 0; form = TDF2; reset(); };
+    ~SOSCascadeT() {};
+
+    // Setters (copies, no allocation; clears the state)
+    void setSections(const SOSSectionT<Sample> *_sections, int n) {
+        count = (n < SOS_MAX_SECTIONS) ? n : SOS_MAX_SECTIONS;
+        memcpy(sections, _sections, sizeof(SOSSectionT<Sample>)*count);
+        reset();
+    };
+    void setForm(int _form) { form = _form; reset(); };
+
+    // Getters
+    int getNumSections() { return count; };
+    int getForm() { return form; };
+    const SOSSectionT<Sample> *getSections() { return sections; };
+
+    // Clears every section's delay line
+    void reset() { memset(state, 0, sizeof(state)); };
+
+    // Block Processing (in place)
+    void processBlock(Sample *buf, int n) {
+        if (form == DF1) processDF1(buf, n);
+        else processTDF2(buf, n);
+    };
+
+    // Single sample, for per-sample chains
+    Sample process(Sample x) {
+        processBlock(&x, 1);
+        return x;
+    };
+
+private:
+    void processDF1(Sample *buf, int n) {
+        for (int s = 0; s < count; s++) {
+            const Sample b0 = sections[s].b0, b1 = sections[s].b1, b2 = sections[s].b2;
+            const Sample a1 = sections[s].a1, a2 = sections[s].a2;
+            Sample x1 = state[s][0], x2 = state[s][1], y1 = state[s][2], y2 = state[s][3];
+
+            for (int i = 0; i < n; i++) {
+                Sample x = buf[i];
+                Sample y = b0*x + b1*x1 + b2*x2 - a1*y1 - a2*y2;
+                x2 = x1; x1 = x;
+                y2 = y1; y1 = y;
+                buf[i] = y;
+            }
+
+            state[s][0] = x1; state[s][1] = x2; state[s][2] = y1; state[s][3] = y2;
+        }
+    };
+
+    void processTDF2(Sample *buf, int n) {
+        for (int s = 0; s < count; s++) {
+            const Sample b0 = sections[s].b0, b1 = sections[s].b1, b2 = sections[s].b2;
+            const Sample a1 = sections[s].a1, a2 = sections[s].a2;
+            Sample s1 = state[s][0], s2 = state[s][1];
+
+            for (int i = 0; i < n; i++) {
+                Sample x = buf[i];
+                Sample y = b0*x + s1;
+                s1 = b1*x - a1*y + s2;
+                s2 = b2*x - a2*y;
+                buf[i] = y;
+            }
+
+            state[s][0] = s1; state[s][1] = s2;
+        }
+    };
+
+    SOSSectionT<Sample> sections[SOS_MAX_SECTIONS];
+    Sample state[SOS_MAX_SECTIONS][4];
+    int count;
+    int form;
+};
+
+typedef SOSSectionT<float> SOSSection;
+typedef SOSCascadeT<float> SOSCascade;
+
+#endif // SOSCASCADE_H
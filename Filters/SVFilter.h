@@ -0,0 +1,308 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   SVFilter.h
+ *
+ *   Description:   Topology-preserving (trapezoidal) state-variable filter
+ *                  Low, band, high pass and notch from the same two integrators.
+ *                  A new cutoff costs one tan approximation and a few multiplies,
+ *                  and the state keeps its meaning when the coefficients change,
+ *                  so the cutoff can move every sample (audio-rate modulation)
+ *                  without the zipper noise or blow-ups of a direct-form biquad.
+ *                  SVFilterBank runs four voices per register.
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef SVFILTER_H
+#define SVFILTER_H
+
+#include <math.h>
+#include <string.h>
+#include <limits>
+#include <vector>
+
+#include "SIMD.h"
+#include "FastMath.h"
+
+#define SVF_MIN_CUTOFF          1.f             // Hz, lowest cutoff accepted
+#define SVF_MAX_CUTOFF          0.49f           // Highest cutoff as a fraction of the sample rate
+#define SVF_TAN_LEVEL           FM_NORMAL       // Prewarp accuracy (~1e-6 relative)
+#define SVF_BANK_CHUNK          64              // Samples per voice interleaved at a time
+
+// Every response of one sample
+template <typename Sample>
+struct SVFOutputs {
+    Sample lp, bp, hp, notch;
+};
+
+template <typename Sample>
+class SVFilterT {
+public:
+    // Output Response
+    enum MODE {
+        LPF = 0,
+        BPF = 1,
+        HPF = 2,
+        NOTCH = 3,
+    };
+
+    // Initializations
+    SVFilterT() { init(44100.f); };
+    SVFilterT(Sample _srate) { init(_srate); };
+    ~SVFilterT() {};
+
+    // Clears the integrators (for reuse)
+    void reset() { ic1 = ic2 = 0; };
+
+    // Filter Setup
+    void setMode(int _mode) { mode = _mode; };
+    void setCutoffFrequency(Sample _fc) { fc = _fc; g = prewarp(fc); update(); };
+    void setQ(Sample _q) { q = _q; k = 1/q; update(); };
+
+    // Getters
+    int getMode() { return mode; };
+    Sample getCutoffFrequency() { return fc; };
+    Sample getQ() { return q; };
+
+    // One sample, all four responses
+    void tick(Sample x, SVFOutputs<Sample> *o) {
+        Sample v1, v2;
+        step(x, &v1, &v2);
+        o->lp = v2;
+        o->bp = v1;
+        o->hp = x - k*v1 - v2;
+        o->notch = x - k*v1;
+    };
+
+    // One sample of the selected response
+    Sample process(Sample x) {
+        Sample v1, v2;
+        step(x, &v1, &v2);
+        switch (mode) {
+            case BPF: return output<BPF>(x, v1, v2);
+            case HPF: return output<HPF>(x, v1, v2);
+            case NOTCH: return output<NOTCH>(x, v1, v2);
+            default: return output<LPF>(x, v1, v2);
+        }
+    };
+
+    /*
+     *  Name: processBlock(const Sample *in, Sample *out, int n)
+     *  Desc: n samples at the current cutoff (in place is fine)
+     */
+    void processBlock(const Sample *in, Sample *out, int n) {
+        switch (mode) {
+            case BPF: run<BPF, false>(in, NULL, out, n); break;
+            case HPF: run<HPF, false>(in, NULL, out, n); break;
+            case NOTCH: run<NOTCH, false>(in, NULL, out, n); break;
+            default: run<LPF, false>(in, NULL, out, n); break;
+        }
+    };
+
+    /*
+     *  Name: processBlockModulated(const Sample *in, const Sample *cutoff, Sample *out, int n)
+     *  Desc: n samples with a new cutoff (Hz) every sample; the last one stays set
+     */
+    void processBlockModulated(const Sample *in, const Sample *cutoff, Sample *out, int n) {
+        if (n <= 0) return;
+        switch (mode) {
+            case BPF: run<BPF, true>(in, cutoff, out, n); break;
+            case HPF: run<HPF, true>(in, cutoff, out, n); break;
+            case NOTCH: run<NOTCH, true>(in, cutoff, out, n); break;
+            default: run<LPF, true>(in, cutoff, out, n); break;
+        }
+        fc = cutoff[n - 1];
+    };
+
+private:
+    void init(Sample _srate) {
+        srate = _srate;
+        mode = LPF;
+        fc = 1000.f;
+        q = (Sample)M_SQRT1_2;
+        k = 1/q;
+        g = prewarp(fc);
+        update();
+        reset();
+    };
+
+    // Integrator gain for a cutoff, clamped to where tan() stays finite
+    Sample prewarp(Sample f) {
+        Sample hi = SVF_MAX_CUTOFF*srate;
+        f = (f < SVF_MIN_CUTOFF) ? SVF_MIN_CUTOFF : ((f > hi) ? hi : f);
+        return sampleTan<SVF_TAN_LEVEL>((Sample)(M_PI/srate)*f);
+    };
+
+    void update() {
+        a1 = 1/(1 + g*(g + k));
+        a2 = g*a1;
+        a3 = g*a2;
+    };
+
+    // Both integrators, trapezoidal: v1 band pass, v2 low pass
+    void step(Sample x, Sample *v1, Sample *v2) {
+        Sample v3 = x - ic2;
+        *v1 = a1*ic1 + a2*v3;
+        *v2 = ic2 + a2*ic1 + a3*v3;
+        ic1 = 2*(*v1) - ic1;
+        ic2 = 2*(*v2) - ic2;
+    };
+
+    template <int M>
+    Sample output(Sample x, Sample v1, Sample v2) {
+        if (M == LPF) return v2;
+        if (M == BPF) return v1;
+        if (M == HPF) return x - k*v1 - v2;
+        return x - k*v1;
+    };
+
+    template <int M, bool MODULATED>
+    void run(const Sample *in, const Sample *cutoff, Sample *out, int n) {
+        for (int i = 0; i < n; i++) {
+            if (MODULATED) {
+                g = prewarp(cutoff[i]);
+                update();
+            }
+            Sample x = in[i], v1, v2;
+            step(x, &v1, &v2);
+            out[i] = output<M>(x, v1, v2);
+        }
+        // underflow check once per block (redundant once FTZ is set on the audio thread)
+        if (fabs(ic1) < std::numeric_limits<Sample>::min()) ic1 = 0;
+        if (fabs(ic2) < std::numeric_limits<Sample>::min()) ic2 = 0;
+    };
+
+    // Integrator states
+    Sample ic1, ic2;
+
+    // Coefficients
+    Sample g, k, a1, a2, a3;
+
+    // Variables
+    Sample srate;
+    Sample fc;
+    Sample q;
+    int mode;
+};
+
+typedef SVFilterT<float> SVFilter;
+
+class SVFilterBank {
+public:
+    // Initializations (_voices rounded up to a multiple of 4)
+    SVFilterBank(float _srate, int _voices) {
+        srate = _srate;
+        voices = _voices;
+        groups = (voices + 3)/4;
+        mode = SVFilter::LPF;
+        ic1.resize(groups);
+        ic2.resize(groups);
+        k.resize(groups, v4set1((float)M_SQRT2));
+        reset();
+    };
+    ~SVFilterBank() {};
+
+    // Clears every voice
+    void reset() {
+        for (int g = 0; g < groups; g++) ic1[g] = ic2[g] = v4set1(0.f);
+    };
+
+    // Clears one voice (e.g. on note on)
+    void reset(int voice) {
+        ic1[voice/4][voice%4] = 0.f;
+        ic2[voice/4][voice%4] = 0.f;
+    };
+
+    // Filter Setup
+    void setMode(int _mode) { mode = _mode; };
+    void setQ(int voice, float q) { k[voice/4][voice%4] = 1.f/q; };
+
+    // Getters
+    int getVoices() { return voices; };
+
+    /*
+     *  Name: process(const float *const *in, const float *const *cutoff, float *const *out, int n)
+     *  Desc: n samples of every voice: in[v] through a cutoff of cutoff[v][i] Hz
+     *        into out[v]. Four voices share each register, so one v4tan
+     *        prewarps four voice-samples.
+     */
+    void process(const float *const *in, const float *const *cutoff, float *const *out, int n) {
+        switch (mode) {
+            case SVFilter::BPF: run<SVFilter::BPF>(in, cutoff, out, n); break;
+            case SVFilter::HPF: run<SVFilter::HPF>(in, cutoff, out, n); break;
+            case SVFilter::NOTCH: run<SVFilter::NOTCH>(in, cutoff, out, n); break;
+            default: run<SVFilter::LPF>(in, cutoff, out, n); break;
+        }
+    };
+
+private:
+    template <int M>
+    void run(const float *const *in, const float *const *cutoff, float *const *out, int n) {
+        const v4sf one = v4set1(1.f), two = v4set1(2.f), w = v4set1((float)(M_PI/srate));
+        const v4sf lo = v4set1(SVF_MIN_CUTOFF), hi = v4set1(SVF_MAX_CUTOFF*srate);
+
+        for (int g = 0; g < groups; g++) {
+            // Lanes past the last voice filter silence
+            int base = 4*g, live = (voices - base < 4) ? voices - base : 4;
+            v4sf s1 = ic1[g], s2 = ic2[g], kk = k[g];
+
+            for (int start = 0; start < n; start += SVF_BANK_CHUNK) {
+                int m = (n - start < SVF_BANK_CHUNK) ? n - start : SVF_BANK_CHUNK;
+
+                // Voices interleaved, four lanes per sample
+                for (int l = 0; l < 4; l++) {
+                    const float *src = (l < live) ? in[base + l] + start : NULL;
+                    const float *fsrc = (l < live) ? cutoff[base + l] + start : NULL;
+                    for (int i = 0; i < m; i++) {
+                        xs[4*i + l] = src ? src[i] : 0.f;
+                        fs[4*i + l] = fsrc ? fsrc[i] : SVF_MIN_CUTOFF;
+                    }
+                }
+
+                for (int i = 0; i < m; i++) {
+                    v4sf x = v4load(xs + 4*i), f = v4load(fs + 4*i);
+                    f = fmSelect((v4si)(f < lo), lo, fmSelect((v4si)(f > hi), hi, f));
+
+                    v4sf gg = v4tan<SVF_TAN_LEVEL>(f*w);
+                    v4sf a1 = one/(one + gg*(gg + kk)), a2 = gg*a1, a3 = gg*a2;
+
+                    v4sf v3 = x - s2;
+                    v4sf v1 = a1*s1 + a2*v3;
+                    v4sf v2 = s2 + a2*s1 + a3*v3;
+                    s1 = two*v1 - s1;
+                    s2 = two*v2 - s2;
+
+                    v4sf y = (M == SVFilter::LPF) ? v2 : (M == SVFilter::BPF) ? v1 :
+                             (M == SVFilter::HPF) ? x - kk*v1 - v2 : x - kk*v1;
+                    v4store(xs + 4*i, y);
+                }
+
+                for (int l = 0; l < live; l++) {
+                    float *dst = out[base + l] + start;
+                    for (int i = 0; i < m; i++) dst[i] = xs[4*i + l];
+                }
+            }
+            // underflow check once per call, as in SVFilterT::run()
+            const v4sf tiny = v4set1(std::numeric_limits<float>::min()), zero = v4set1(0.f);
+            ic1[g] = fmSelect((v4si)(s1 < tiny && s1 > -tiny), zero, s1);
+            ic2[g] = fmSelect((v4si)(s2 < tiny && s2 > -tiny), zero, s2);
+        }
+    };
+
+    float srate;
+    int voices, groups;
+    int mode;
+    std::vector<v4sf> ic1, ic2;     // Integrator states, four voices each
+    std::vector<v4sf> k;            // 1/Q per voice
+    float xs[4*SVF_BANK_CHUNK];     // Interleaved input, then output, of one group
+    float fs[4*SVF_BANK_CHUNK];     // Interleaved cutoffs
+};
+
+#endif // SVFILTER_H
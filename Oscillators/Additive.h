@@ -0,0 +1,195 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   Additive.h
+ *
+ *   Description:   Additive oscillator bank (up to 512 partials)
+ *                  Each partial is a unit phasor rotated once per sample, four
+ *                  partials per vector. Amplitudes ramp over a chunk when they
+ *                  change, phasors are renormalized after every chunk, and
+ *                  partials fade out approaching Nyquist.
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef ADDITIVE_H
+#define ADDITIVE_H
+
+#include <math.h>
+#include <string.h>
+
+#include "SIMD.h"
+#include "FastMath.h"
+
+#define ADDITIVE_MAX_PARTIALS   512             // Multiple of 8
+#define ADDITIVE_CHUNK          64              // Samples per pass, and between renormalizations
+#define ADDITIVE_TAPER          0.45f           // Partials fade from here to Nyquist (fraction of srate)
+
+class Additive {
+public:
+    // Initializations
+    Additive(float _srate = 44100.f) {
+        srate = _srate;
+        freq = 0.f;
+        memset(ratio, 0, sizeof(ratio));
+        memset(level, 0, sizeof(level));
+        memset(rotRe, 0, sizeof(rotRe));
+        memset(rotIm, 0, sizeof(rotIm));
+        memset(target, 0, sizeof(target));
+        memset(amp, 0, sizeof(amp));
+        targetGroups = 0;
+        setSawtooth(ADDITIVE_MAX_PARTIALS);
+        reset();
+    };
+    ~Additive() {};
+
+    // All partials back to phase zero, amplitudes start at their targets for
+    // whatever frequency is set before the next render (no ramp from a past use)
+    void reset() {
+        for (int k = 0; k < ADDITIVE_MAX_PARTIALS; k++) {
+            re[k] = 1.f;
+            im[k] = 0.f;
+        }
+        fresh = true;
+    };
+
+    void setSampleRate(float _srate) { srate = _srate; update(); };
+
+    // Fundamental; partial k runs at freq*ratio[k]
+    void setFrequency(float _freq) { freq = _freq; update(); };
+
+    // Partial k (0-based) at ratio times the fundamental, peak amplitude amp
+    void setPartial(int k, float _ratio, float _amp) {
+        if (k < 0 || k >= ADDITIVE_MAX_PARTIALS) return;
+        ratio[k] = _ratio;
+        level[k] = _amp;
+        update();
+    };
+
+    // First n harmonics at 1/k, a band-limited sawtooth; the rest silent
+    void setSawtooth(int n) {
+        for (int k = 0; k < ADDITIVE_MAX_PARTIALS; k++) {
+            ratio[k] = (float)(k + 1);
+            level[k] = (k < n) ? (float)(2.0/M_PI)/(k + 1) : 0.f;
+        }
+        update();
+    };
+
+    // Getters
+    float getRatio(int k) { return ratio[k]; };
+    float getLevel(int k) { return level[k]; };
+    int getActivePartials() { return 4*targetGroups; };    // rounded up to a group
+
+    /*
+     *  Name: render(float *out, int n)
+     *  Desc: n samples of the sum of all partials
+     */
+    void render(float *out, int n) {
+        while (n > 0) {
+            int len = (n < ADDITIVE_CHUNK) ? n : ADDITIVE_CHUNK;
+            renderChunk(out, len);
+            out += len;
+            n -= len;
+        }
+    };
+
+private:
+    void renderChunk(float *out, int len) {
+        if (fresh) {
+            memcpy(amp, target, sizeof(amp));
+            groups = targetGroups;
+            fresh = false;
+        }
+
+        v4sf acc[ADDITIVE_CHUNK];
+        for (int i = 0; i < len; i++) acc[i] = v4set1(0.f);
+
+        // Groups still sounding or ramping down; two at a time to overlap their recursions
+        int count = (groups > targetGroups) ? groups : targetGroups;
+        float step = 1.f/len;
+        int g = 0;
+        for (; g + 2 <= count; g += 2) {
+            int k = 4*g;
+            v4sf cr0 = v4load(re + k), ci0 = v4load(im + k), wr0 = v4load(rotRe + k), wi0 = v4load(rotIm + k);
+            v4sf cr1 = v4load(re + k + 4), ci1 = v4load(im + k + 4), wr1 = v4load(rotRe + k + 4), wi1 = v4load(rotIm + k + 4);
+            v4sf a0 = v4load(amp + k), da0 = (v4load(target + k) - a0)*step;
+            v4sf a1 = v4load(amp + k + 4), da1 = (v4load(target + k + 4) - a1)*step;
+            for (int i = 0; i < len; i++) {
+                acc[i] += a0*ci0 + a1*ci1;
+                v4sf t0 = cr0*wr0 - ci0*wi0, t1 = cr1*wr1 - ci1*wi1;
+                ci0 = cr0*wi0 + ci0*wr0;
+                ci1 = cr1*wi1 + ci1*wr1;
+                cr0 = t0;
+                cr1 = t1;
+                a0 += da0;
+                a1 += da1;
+            }
+            storeGroup(k, cr0, ci0);
+            storeGroup(k + 4, cr1, ci1);
+        }
+        for (; g < count; g++) {
+            int k = 4*g;
+            v4sf cr = v4load(re + k), ci = v4load(im + k), wr = v4load(rotRe + k), wi = v4load(rotIm + k);
+            v4sf a = v4load(amp + k), da = (v4load(target + k) - a)*step;
+            for (int i = 0; i < len; i++) {
+                acc[i] += a*ci;
+                v4sf t = cr*wr - ci*wi;
+                ci = cr*wi + ci*wr;
+                cr = t;
+                a += da;
+            }
+            storeGroup(k, cr, ci);
+        }
+
+        for (int i = 0; i < len; i++) out[i] = v4sum(acc[i]);
+        memcpy(amp, target, sizeof(float)*4*count);
+        groups = targetGroups;
+    };
+
+    // Phasor back to memory at unit length (one Newton step, drift per chunk is tiny)
+    void storeGroup(int k, v4sf cr, v4sf ci) {
+        v4sf g = 1.5f - 0.5f*(cr*cr + ci*ci);
+        v4store(re + k, cr*g);
+        v4store(im + k, ci*g);
+    };
+
+    // Rotations and band-limited targets after a frequency or partial change
+    void update() {
+        float hi = 0.5f*srate, lo = ADDITIVE_TAPER*srate;
+        targetGroups = 0;
+        for (int k = 0; k < ADDITIVE_MAX_PARTIALS; k += 4) {
+            v4sf f = v4load(ratio + k)*freq, s, c;
+            v4sincos<FM_PRECISE>(f*(float)(2.0*M_PI/srate), &s, &c);
+            v4store(rotRe + k, c);
+            v4store(rotIm + k, s);
+
+            for (int j = k; j < k + 4; j++) {
+                float fj = fabsf(f[j - k]), w = 1.f;
+                if (fj >= hi) w = 0.f;
+                else if (fj > lo) w = 0.5f + 0.5f*cosf((float)M_PI*(fj - lo)/(hi - lo));
+                target[j] = level[j]*w;
+                if (w == 0.f) amp[j] = 0.f;     // above Nyquist: cut now, ramping down would alias
+                if (target[j] != 0.f) targetGroups = k/4 + 1;
+            }
+        }
+    };
+
+    float srate, freq;
+    bool fresh;                             // reset since the last render
+    int groups, targetGroups;               // groups of 4 partials with amp / target non-zero
+
+    float ratio[ADDITIVE_MAX_PARTIALS];     // frequency over the fundamental
+    float level[ADDITIVE_MAX_PARTIALS];     // amplitude as set
+    float target[ADDITIVE_MAX_PARTIALS];    // level after band limiting
+    float amp[ADDITIVE_MAX_PARTIALS];       // amplitude now (ramps to target)
+    float re[ADDITIVE_MAX_PARTIALS], im[ADDITIVE_MAX_PARTIALS];         // phasors (im is the output)
+    float rotRe[ADDITIVE_MAX_PARTIALS], rotIm[ADDITIVE_MAX_PARTIALS];   // per-sample rotation
+};
+
+#endif // ADDITIVE_H
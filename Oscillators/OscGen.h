@@ -4,7 +4,11 @@
  *      Filename:   OscGen.h
  *
  *   Description:   Oscillator Waveform Generator
- *  
+ *                  Templated on the sample type (OscGen is the float one); the
+ *                  additive bank stays float and is converted per chunk. The
+ *                  bank is allocated the first time ADDITIVE is selected and
+ *                  only follows the frequency while ADDITIVE is the waveform.
+ *
  *       Version:   1.0
  *       Created:   12/26/2015
  *
@@ -19,7 +23,13 @@
 
 #include <math.h>
 
-class OscGen {
+#include "FastMath.h"
+#include "Additive.h"
+
+#define NOISE_MAX               0x7fffffff      // Range of the noise generator
+
+template <typename Sample>
+class OscGenT {
 public:
     // Waveform Type
     enum WAVEFORM {
@@ -29,37 +39,77 @@ public:
         SQR = 3,            // Square Wave
         WHITE = 4,          // White Noise 
         PINK = 5,           // Pink Noise
+        ADDITIVE = 6,       // Additive partials (band-limited sawtooth by default)
     };
 
     // Initializations
-    OscGen () { 
+    OscGenT () { 
         srate = 44100.f; 
         freq = 0.f; 
         phs = 0.f; 
         phs_incr = 2*M_PI*freq/srate; 
         if (freq != 0) T = srate/freq;
         firstWrap = false;
+        seed = 22222;
+        waveform = SIN;
+        additive = NULL;
+        reset();
     };
-    OscGen (float _srate) { 
+    OscGenT (Sample _srate) { 
         srate = _srate; 
         freq = 0;
         phs = 0; 
         phs_incr = 2*M_PI*freq/srate; 
         T = srate/freq;
         firstWrap = false;
+        seed = 22222;
+        waveform = SIN;
+        additive = NULL;
+        reset();
+    };
+    ~OscGenT() { delete additive; };
+
+    // Clears phase and noise state (for reuse from a pool)
+    void reset() {
+        phs = 0;
+        saw_sample = 0;
+        firstWrap = false;
+        state[0] = state[1] = state[2] = 0;
+        seed = 22222;
+        if (additive != NULL) additive->reset();
+        addPos = ADDITIVE_CHUNK;
     };
-    ~OscGen();
 
     // Setters
-    void setFrequency(float _freq) { freq = _freq; phs_incr = 2*M_PI*freq/srate; T = srate/freq; firstWrap = false; };
-    void setWaveform(int _wform) { waveform = _wform; };
+    // The 512-partial update only runs for ADDITIVE; selecting it catches the bank up
+    void setFrequency(Sample _freq) {
+        freq = _freq; phs_incr = 2*M_PI*freq/srate; T = srate/freq; firstWrap = false;
+        if (waveform == ADDITIVE) additive->setFrequency(freq);
+    };
+    void setWaveform(int _wform) {
+        waveform = _wform;
+        if (waveform == ADDITIVE) getAdditive()->setFrequency(freq);
+    };
 
     int getWaveform() { return waveform; };
 
     bool isWrapped() { return firstWrap; };
 
+    // Partials of the ADDITIVE waveform (ratio to the fundamental, amplitude);
+    // allocates the bank on first use, so never from the audio thread
+    Additive *getAdditive() {
+        if (additive == NULL) additive = new Additive((float)srate);
+        return additive;
+    };
+
+    // Noise source: rand() takes a lock in most libcs, not allowed in the callback
+    unsigned int noise() {
+        seed = seed * 1103515245u + 12345u;
+        return (seed >> 1) & NOISE_MAX;
+    };
+
     // Phase Wrapper
-    float wrapPhase(float _phs) {
+    Sample wrapPhase(Sample _phs) {
         if (phs >= (2*M_PI)) {
             firstWrap = true;
             phs -= (2*M_PI);
@@ -68,14 +118,13 @@ public:
     };
 
     // Waveform Selector
-    float generateSample() {
+    Sample generateSample() {
         //TODO: silence when switching waveforms
-        float sample = 0;
-        static float saw_sample;
+        Sample sample = 0;
 
         switch (waveform) {
             case SIN: {
-                sample = sinf(phs);
+                sample = sampleSin(phs);
          
                 phs += phs_incr;
                 phs = wrapPhase(phs);
@@ -92,16 +141,16 @@ public:
 
             case TRI: {
                 saw_sample += 2./T;
-                sample = fabsf(saw_sample) * 2.f - 1.f;
+                sample = fabs(saw_sample) * 2.f - 1.f;
 
                 if (saw_sample >= 1.f) saw_sample -= 2.f;
                 break;
             }
 
             case SQR: {
-                sample = sinf(phs);
-                if (sample > 0) sample = 1;
-                else if (sample < 0) sample = -1;
+                // Sign of sin(phs), phs is in [0, 2pi)
+                if (phs == 0) sample = 0;
+                else sample = (phs < M_PI) ? 1.f : -1.f;
         
                 phs += phs_incr;
                 phs = wrapPhase(phs);
@@ -109,42 +158,117 @@ public:
             }
 
             case WHITE: {
-                float R1 = (float) rand() / (float) RAND_MAX;
-                float R2 = (float) rand() / (float) RAND_MAX;
+                Sample R1 = (Sample) (noise() + 1) / (Sample) NOISE_MAX;
+                Sample R2 = (Sample) noise() / (Sample) NOISE_MAX;
 
-                sample = (float) sqrt( -2.0f * log( R1 )) * cos( 2.0f * M_PI * R2 ) / 2.f;
+                // Box-Muller; R1 can round to just above 1, hence the clamp
+                Sample r = -2.0f * (Sample)M_LN2 * sampleLog2( R1 );
+                sample = sqrt( r > 0.f ? r : (Sample)0 ) * sampleCos( 2.0f * (Sample)M_PI * R2 ) / 2.f;
                 break;
             }
 
             case PINK: {
-                static const float RMI2 = 2.0 / float(RAND_MAX); // + 1.0; // change for range [0,1)
-                static const float offset = A[0] + A[1] + A[2];
+                static const Sample RMI2 = 2.0 / Sample(NOISE_MAX); // + 1.0; // change for range [0,1)
+                static const Sample offset = A[0] + A[1] + A[2];
 
                  // unrolled loop
-                float temp = float(rand());
+                Sample temp = Sample(noise());
                 state[0] = P[0] * (state[0] - temp) + temp;
-                temp = float(rand());
+                temp = Sample(noise());
                 state[1] = P[1] * (state[1] - temp) + temp;
-                temp = float(rand());        
+                temp = Sample(noise());        
                 state[2] = P[2] * (state[2] - temp) + temp;
                 sample = ((A[0]*state[0] + A[1]*state[1] + A[2]*state[2])*RMI2 - offset)*2.f;
                 break;
             }
 
+            case ADDITIVE: {
+                // Rendered a chunk ahead, so a new frequency lands within ADDITIVE_CHUNK samples
+                if (addPos == ADDITIVE_CHUNK) {
+                    additive->render(addBuf, ADDITIVE_CHUNK);
+                    addPos = 0;
+                }
+                sample = addBuf[addPos++];
+                break;
+            }
+
 
         };
 
         return sample;
     };
 
+    /*
+     *  Name: generateBlock(Sample *out, int n)
+     *  Desc: n samples at once; the additive bank renders straight into out,
+     *        the float sine four phases per v4sin call
+     */
+    void generateBlock(Sample *out, int n) {
+        if (waveform == SIN) {
+            renderSin(out, n);
+            return;
+        }
+        if (waveform != ADDITIVE) {
+            for (int i = 0; i < n; i++) out[i] = generateSample();
+            return;
+        }
+
+        // Samples already rendered for generateSample() come first
+        int i = 0;
+        while (i < n && addPos < ADDITIVE_CHUNK) out[i++] = addBuf[addPos++];
+        renderAdditive(out + i, n - i);
+    };
+
 private:
-    float freq, srate, phs, phs_incr, T;
+    // Phases advance one sample at a time as in generateSample(), so the block
+    // and per-sample paths stay in step; the double sine keeps libm
+    void renderSin(float *out, int n) {
+        int i = 0;
+        for (; i + 4 <= n; i += 4) {
+            float p[4];
+            for (int k = 0; k < 4; k++) {
+                p[k] = phs;
+                phs += phs_incr;
+                phs = wrapPhase(phs);
+            }
+            v4store(out + i, v4sin(v4load(p)));
+        }
+        for (; i < n; i++) out[i] = generateSample();
+    };
+    void renderSin(double *out, int n) {
+        for (int i = 0; i < n; i++) out[i] = generateSample();
+    };
+
+    // The bank renders float: straight into a float block, otherwise a chunk
+    // at a time through addBuf (only called once addBuf is used up)
+    void renderAdditive(float *out, int n) { additive->render(out, n); };
+    void renderAdditive(double *out, int n) {
+        for (int i = 0; i < n; i += ADDITIVE_CHUNK) {
+            int m = (n - i < ADDITIVE_CHUNK) ? n - i : ADDITIVE_CHUNK;
+            additive->render(addBuf, m);
+            convertSamples(addBuf, out + i, m);
+        }
+    };
+
+    Sample freq, srate, phs, phs_incr, T;
+    Sample saw_sample;      // Per instance, two oscillators run during a crossfade
     int waveform;
     bool firstWrap;
+    unsigned int seed;
+
+    Additive *additive;             // NULL until ADDITIVE is first selected
+    float addBuf[ADDITIVE_CHUNK];   // Chunk being read out by generateSample()
+    int addPos;
 
-    float state[3];
-    const float A[3] = { 0.02109238, 0.07113478, 0.68873558 }; // rescaled by (1+P)/(1-P)
-    const float P[3] = { 0.3190,  0.7756,  0.9613  };
+    Sample state[3];
+    const Sample A[3] = { 0.02109238, 0.07113478, 0.68873558 }; // rescaled by (1+P)/(1-P)
+    const Sample P[3] = { 0.3190,  0.7756,  0.9613  };
+
+    // Owns the bank
+    OscGenT(const OscGenT &) = delete;
+    OscGenT &operator=(const OscGenT &) = delete;
 };
 
+typedef OscGenT<float> OscGen;
+
 #endif  // OSCGEN_H
@@ -0,0 +1,165 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   Builtin.h
+ *
+ *   Description:   The app's own BiquadFilter and OscGen as DSPPlugin tables
+ *                  The reference side of an A/B comparison: "builtin:biquad",
+ *                  "builtin:biquad64" (the same filter in double), "builtin:svf"
+ *                  and "builtin:osc" on the command line
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef BUILTIN_H
+#define BUILTIN_H
+
+#include <string.h>
+
+#include "DSPPlugin.h"
+#include "BiquadFilter.h"
+#include "SVFilter.h"
+#include "OscGen.h"
+
+#define BUILTIN_PREFIX          "builtin:"
+
+/*
+ *  BiquadFilterT<Sample>, processBlock() (float blocks converted at the edges)
+ */
+template <typename Sample>
+static void *builtinBiquadCreate(float srate, int maxBlock) {
+    BiquadFilterT<Sample> *f = new BiquadFilterT<Sample>(srate);
+    f->setCutoffFrequency(1000.f);
+    f->setQ(0.707f);
+    f->setFilterType(BiquadFilter::SO_LPF);
+    return f;
+}
+template <typename Sample>
+static void builtinBiquadDestroy(void *self) { delete (BiquadFilterT<Sample> *)self; }
+template <typename Sample>
+static void builtinBiquadReset(void *self) { ((BiquadFilterT<Sample> *)self)->reset(); }
+template <typename Sample>
+static void builtinBiquadSetParam(void *self, int id, float value) {
+    BiquadFilterT<Sample> *f = (BiquadFilterT<Sample> *)self;
+    switch (id) {
+        case DSP_PARAM_CUTOFF: f->setCutoffFrequency(value); break;
+        case DSP_PARAM_Q: f->setQ(value); break;
+        case DSP_PARAM_TYPE: f->setFilterType(value); break;
+        default: return;
+    }
+    f->configureFilter();
+}
+template <typename Sample>
+static void builtinBiquadProcess(void *self, const float *in, float *out, int n) {
+    ((BiquadFilterT<Sample> *)self)->processBlock(in, out, n);
+}
+
+/*
+ *  SVFilter behind the biquad's parameters: type is BiquadFilter::FILTER, run
+ *  as the nearest SVF response, and the output is (H + 1)/2 like
+ *  processBiquad(), so an A/B against builtin:biquad compares one response.
+ *  The low/high-pass types agree to about -110 dB in an --ab run, the
+ *  band-pass and notch to about -55 dB (the biquad warps their bandwidth its
+ *  own way). Not equivalent: the first-order types (second-order here) and the
+ *  Butterworth BPF/BSF bandwidth. The biquad also clears its state on exactly
+ *  zero input where the SVF rings out; --ab resets both before each part of
+ *  its stimulus and measures the silence on its own, so that doesn't count.
+ */
+typedef struct {
+    SVFilter svf;
+    int type;               // BiquadFilter::FILTER
+    float q;                // As set; the Butterworth LPF/HPF run at 1/sqrt(2)
+} BuiltinSVF;
+
+static void builtinSVFConfigure(BuiltinSVF *f) {
+    static const int modes[] = { SVFilter::LPF, SVFilter::HPF, SVFilter::LPF, SVFilter::LPF, SVFilter::HPF,
+                                 SVFilter::BPF, SVFilter::NOTCH, SVFilter::LPF, SVFilter::HPF, SVFilter::BPF,
+                                 SVFilter::NOTCH };
+    int t = (f->type >= BiquadFilter::FO_LPF && f->type <= BiquadFilter::SO_BSF_BUTTERS) ? f->type : BiquadFilter::SO_LPF;
+    bool butter = (t == BiquadFilter::SO_LPF_BUTTERS || t == BiquadFilter::SO_HPF_BUTTERS);
+    f->svf.setMode(modes[t]);
+    f->svf.setQ(butter ? (float)M_SQRT1_2 : f->q);
+}
+static void *builtinSVFCreate(float srate, int maxBlock) {
+    BuiltinSVF *f = new BuiltinSVF;
+    f->svf = SVFilter(srate);
+    f->svf.setCutoffFrequency(1000.f);
+    f->type = BiquadFilter::SO_LPF;
+    f->q = 0.707f;
+    builtinSVFConfigure(f);
+    return f;
+}
+static void builtinSVFDestroy(void *self) { delete (BuiltinSVF *)self; }
+static void builtinSVFReset(void *self) { ((BuiltinSVF *)self)->svf.reset(); }
+static void builtinSVFSetParam(void *self, int id, float value) {
+    BuiltinSVF *f = (BuiltinSVF *)self;
+    if (id == DSP_PARAM_CUTOFF) f->svf.setCutoffFrequency(value);
+    else if (id == DSP_PARAM_Q) f->q = value;
+    else if (id == DSP_PARAM_TYPE) f->type = (int)value;
+    else return;
+    builtinSVFConfigure(f);
+}
+static void builtinSVFProcess(void *self, const float *in, float *out, int n) {
+    BuiltinSVF *f = (BuiltinSVF *)self;
+    // The SVF band-pass peaks at Q, the biquad's at unity
+    float gain = (f->svf.getMode() == SVFilter::BPF) ? 1.f/f->svf.getQ() : 1.f;
+    float dry[BIQUAD_CHUNK];
+    for (int start = 0; start < n; start += BIQUAD_CHUNK) {
+        int m = (n - start < BIQUAD_CHUNK) ? n - start : BIQUAD_CHUNK;
+        memcpy(dry, in + start, sizeof(float)*m);
+        f->svf.processBlock(dry, out + start, m);
+        for (int i = 0; i < m; i++) out[start + i] = (gain*out[start + i] + dry[i])/2;
+    }
+}
+
+/*
+ *  OscGen, input ignored
+ */
+static void *builtinOscCreate(float srate, int maxBlock) {
+    OscGen *o = new OscGen(srate);
+    o->setWaveform(OscGen::SIN);
+    o->setFrequency(440.f);
+    return o;
+}
+static void builtinOscDestroy(void *self) { delete (OscGen *)self; }
+static void builtinOscReset(void *self) { ((OscGen *)self)->reset(); }
+static void builtinOscSetParam(void *self, int id, float value) {
+    OscGen *o = (OscGen *)self;
+    if (id == DSP_PARAM_FREQUENCY) o->setFrequency(value);
+    else if (id == DSP_PARAM_TYPE) o->setWaveform((int)value);
+}
+static void builtinOscProcess(void *self, const float *in, float *out, int n) {
+    ((OscGen *)self)->generateBlock(out, n);
+}
+
+/*
+ *  Name: builtinPlugin(const char *spec)
+ *  Desc: Table for "builtin:<name>", NULL if spec names no built-in module
+ */
+static inline const DSPPlugin *builtinPlugin(const char *spec) {
+    static const DSPPlugin biquad = { DSP_PLUGIN_ABI, "BiquadFilter", builtinBiquadCreate<float>, builtinBiquadDestroy<float>,
+                                      builtinBiquadReset<float>, builtinBiquadSetParam<float>, builtinBiquadProcess<float> };
+    static const DSPPlugin biquad64 = { DSP_PLUGIN_ABI, "BiquadFilterT<double>", builtinBiquadCreate<double>,
+                                        builtinBiquadDestroy<double>, builtinBiquadReset<double>,
+                                        builtinBiquadSetParam<double>, builtinBiquadProcess<double> };
+    static const DSPPlugin svf = { DSP_PLUGIN_ABI, "SVFilter", builtinSVFCreate, builtinSVFDestroy,
+                                   builtinSVFReset, builtinSVFSetParam, builtinSVFProcess };
+    static const DSPPlugin osc = { DSP_PLUGIN_ABI, "OscGen", builtinOscCreate, builtinOscDestroy,
+                                   builtinOscReset, builtinOscSetParam, builtinOscProcess };
+
+    if (strncmp(spec, BUILTIN_PREFIX, strlen(BUILTIN_PREFIX)) != 0) return NULL;
+    const char *name = spec + strlen(BUILTIN_PREFIX);
+    if (!strcmp(name, "biquad")) return &biquad;
+    if (!strcmp(name, "biquad64")) return &biquad64;
+    if (!strcmp(name, "svf")) return &svf;
+    if (!strcmp(name, "osc")) return &osc;
+    return NULL;
+}
+
+#endif // BUILTIN_H
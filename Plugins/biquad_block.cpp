@@ -0,0 +1,102 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   biquad_block.cpp
+ *
+ *   Description:   Example DSP module: BiquadFilter's design and difference
+ *                  equation as one block loop with the state in registers
+ *                  Same output as builtin:biquad to float rounding:
+ *                      make plugins
+ *                      ./main --ab builtin:biquad Plugins/biquad_block.so
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#include <math.h>
+#include <float.h>
+
+#include "DSPPlugin.h"
+#include "BiquadFilter.h"
+
+struct BiquadBlock {
+    BiquadFilter design;                // coefficient design only
+    float ga0, ga1, ga2, b1, b2;        // gain folded into the feedforward taps
+    float x1, x2, y1, y2;
+};
+
+// processBiquad() returns (y + x)/2, which getCoefficients() folds into one section;
+// unfold it to run the same recursion on y
+static void biquadBlockDesign(BiquadBlock *f) {
+    SOSSection s;
+    f->design.configureFilter();
+    f->design.getCoefficients(&s);
+    f->b1 = s.a1;
+    f->b2 = s.a2;
+    f->ga0 = 2.f*s.b0 - 1.f;
+    f->ga1 = 2.f*s.b1 - s.a1;
+    f->ga2 = 2.f*s.b2 - s.a2;
+}
+
+static void *biquadBlockCreate(float srate, int maxBlock) {
+    BiquadBlock *f = new BiquadBlock;
+    f->design = BiquadFilter(srate);
+    f->design.setCutoffFrequency(1000.f);
+    f->design.setQ(0.707f);
+    f->design.setFilterType(BiquadFilter::SO_LPF);
+    biquadBlockDesign(f);
+    f->x1 = f->x2 = f->y1 = f->y2 = 0.f;
+    return f;
+}
+
+static void biquadBlockDestroy(void *self) { delete (BiquadBlock *)self; }
+
+static void biquadBlockReset(void *self) {
+    BiquadBlock *f = (BiquadBlock *)self;
+    f->x1 = f->x2 = f->y1 = f->y2 = 0.f;
+}
+
+static void biquadBlockSetParam(void *self, int id, float value) {
+    BiquadBlock *f = (BiquadBlock *)self;
+    switch (id) {
+        case DSP_PARAM_CUTOFF: f->design.setCutoffFrequency(value); break;
+        case DSP_PARAM_Q: f->design.setQ(value); break;
+        case DSP_PARAM_TYPE: f->design.setFilterType(value); break;
+        default: return;
+    }
+    biquadBlockDesign(f);
+}
+
+static void biquadBlockProcess(void *self, const float *in, float *out, int n) {
+    BiquadBlock *f = (BiquadBlock *)self;
+    float ga0 = f->ga0, ga1 = f->ga1, ga2 = f->ga2, b1 = f->b1, b2 = f->b2;
+    float x1 = f->x1, x2 = f->x2, y1 = f->y1, y2 = f->y2;
+
+    for (int i = 0; i < n; i++) {
+        float x = in[i];
+        float y = ga0*x + ga1*x1 + ga2*x2 - b1*y1 - b2*y2;
+        if (fabsf(y) < FLT_MIN) y = 0.f;
+
+        // processBiquad() silences and clears the feedback on an exact zero input
+        if (x == 0.f) y = y1 = 0.f;
+
+        y2 = y1;
+        y1 = y;
+        x2 = x1;
+        x1 = x;
+        out[i] = (y + x)*0.5f;
+    }
+
+    f->x1 = x1; f->x2 = x2; f->y1 = y1; f->y2 = y2;
+}
+
+DSP_PLUGIN_EXPORT const DSPPlugin *dsp_plugin(void) {
+    static const DSPPlugin desc = { DSP_PLUGIN_ABI, "biquad-block", biquadBlockCreate, biquadBlockDestroy,
+                                    biquadBlockReset, biquadBlockSetParam, biquadBlockProcess };
+    return &desc;
+}
@@ -0,0 +1,133 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   ABHarness.h
+ *
+ *   Description:   A/B comparison of two DSP modules
+ *                  Both modules get the identical input block; each is timed on
+ *                  its own and the difference between their outputs is tracked
+ *                  (max and RMS). One output is passed on, so the pair can sit in
+ *                  the live signal path as well as run offline.
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef ABHARNESS_H
+#define ABHARNESS_H
+
+#include <math.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include "DSPModule.h"
+#include "TripleBuffer.h"
+
+// Running totals since the last clear
+struct ABStats {
+    unsigned long long samples;
+    double secondsA, secondsB;      // time spent in each module's process()
+    double sumSqA, sumSqDiff;
+    float peakA, maxDiff;
+    int monitor;                    // output passed on, 0 = A, 1 = B
+};
+
+class ABHarness {
+public:
+    // Initializations (the harness owns both modules)
+    ABHarness(DSPModule *_a, DSPModule *_b, int _maxBlock) : snapshot(ABStats()) {
+        a = _a;
+        b = _b;
+        maxBlock = _maxBlock;
+        outA.resize(maxBlock);
+        outB.resize(maxBlock);
+        monitor = 0;
+        clear();
+    };
+    ~ABHarness() { delete a; delete b; };
+
+    // Getters
+    DSPModule *getA() { return a; };
+    DSPModule *getB() { return b; };
+
+    // Same parameter to both
+    void setParam(int id, float value) { a->setParam(id, value); b->setParam(id, value); };
+
+    // Which output process() passes on (any thread)
+    void setMonitor(int m) { monitor.store(m, std::memory_order_relaxed); };
+    int getMonitor() { return monitor.load(std::memory_order_relaxed); };
+
+    // Totals back to zero (the thread calling process(), or before it starts)
+    void clear() {
+        memset(&stats, 0, sizeof(stats));
+        blocks = 0;
+    };
+
+    /*
+     *  Name: process(const float *in, float *out, int n)
+     *  Desc: Runs both modules on in (n <= maxBlock), out gets the monitored one
+     */
+    void process(const float *in, float *out, int n) {
+        // Alternate which runs first, so neither always finds the caches warm
+        if (blocks++ & 1) {
+            stats.secondsB += run(b, in, &outB[0], n);
+            stats.secondsA += run(a, in, &outA[0], n);
+        }
+        else {
+            stats.secondsA += run(a, in, &outA[0], n);
+            stats.secondsB += run(b, in, &outB[0], n);
+        }
+
+        double sa = 0, sd = 0;
+        float pa = stats.peakA, md = stats.maxDiff;
+        for (int i = 0; i < n; i++) {
+            float d = outB[i] - outA[i];
+            sa += (double)outA[i]*outA[i];
+            sd += (double)d*d;
+            pa = fmaxf(pa, fabsf(outA[i]));
+            md = fmaxf(md, fabsf(d));
+        }
+        stats.sumSqA += sa;
+        stats.sumSqDiff += sd;
+        stats.peakA = pa;
+        stats.maxDiff = md;
+        stats.samples += n;
+        stats.monitor = getMonitor();
+
+        memcpy(out, stats.monitor ? &outB[0] : &outA[0], sizeof(float)*n);
+
+        snapshot.edit() = stats;
+        snapshot.publish();
+    };
+
+    // Totals so far, from the thread calling process()
+    const ABStats &getStats() { return stats; };
+
+    // Newest totals, from one other thread
+    const ABStats &read() { bool changed; return snapshot.read(&changed); };
+
+private:
+    static double run(DSPModule *m, const float *in, float *out, int n) {
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        m->process(in, out, n);
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    };
+
+    DSPModule *a, *b;
+    int maxBlock;
+    std::vector<float> outA, outB;
+    std::atomic<int> monitor;
+
+    ABStats stats;
+    unsigned long long blocks;
+    TripleBuffer<ABStats> snapshot;
+};
+
+#endif // ABHARNESS_H
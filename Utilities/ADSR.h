@@ -2,9 +2,14 @@
  * ==================================================================================
  *
  *      Filename:   ADSR.h
- *      
+ *
  *   Description:   ADSR (attack decay sustain release) envelope Implementation
- *  
+ *                  Each segment knows how many samples it has left, so a block is
+ *                  rendered as whole runs of one recursion (cur = cur*mul + add:
+ *                  linear ramps or one-pole analog-style curves) and sustain/idle
+ *                  as constants. Templated on the sample type (ADSR is the float
+ *                  one), vectors of SampleVec width.
+ *
  *       Version:   1.0
  *       Created:   12/30/2015
  *
@@ -16,7 +21,18 @@
 #ifndef ADSR_H
 #define ADSR_H
 
-class ADSR {
+#include <math.h>
+
+#include "SIMD.h"
+
+// Exponential curves aim past the goal by this fraction of the distance, so the
+// one-pole reaches it in finite time (larger is closer to linear)
+#define ADSR_ATTACK_OVERSHOOT   0.3f            // Rounded, capacitor-charge attack
+#define ADSR_DECAY_OVERSHOOT    0.001f          // Near-exponential decay and release
+#define ADSR_MAX_SEGMENT        (1 << 30)       // Samples, for vanishing rates
+
+template <typename Sample>
+class ADSRT {
 public:
     // Envelope Status
     enum {
@@ -27,144 +43,243 @@ public:
         IDLE
     };
 
-    // Initializations
-    ADSR() {
-        srate = 44100.f;
-        target = cur = 0;
-        aRate = dRate = 0.001;
-        rRate - 0.005;
-        rTime = -1.0;
-        sustain = 0.5;
-        state = IDLE;
-    };
-    ADSR(float _srate) {
-        srate = _srate;
-        target = cur = 0;
-        aRate = dRate = 0.001;
-        rRate - 0.005;
-        rTime = -1.0;
-        sustain = 0.5;
-        state = IDLE;
+    // Segment Shape
+    enum CURVE {
+        LINEAR = 0,
+        EXPONENTIAL = 1,
     };
-    ~ADSR();
+
+    // Initializations
+    ADSRT() { init(44100.f); };
+    ADSRT(Sample _srate) { init(_srate); };
+    ~ADSRT() {};
 
     void keyOn() {
-        if (target <= 0.0) target = 1.0;
-        state = ATTACK;
+        startSegment(ATTACK, peak, aRate);
     };
 
     void keyOff() {
-        target = 0.0;
-        state = RELEASE;
         if (rTime > 0) rRate = cur / (rTime * srate);
+        startSegment(RELEASE, 0.f, rRate);
     };
 
-    void setAttackRate(float rate) {
-        aRate =rate;
+    void setCurve(int _curve) {
+        curve = _curve;
     };
 
-    void setAttackTarget(float _target) {
-        target = _target;
+    void setAttackRate(Sample rate) {
+        aRate = rate;
     };
 
-    void setDecayRate(float rate) {
+    void setAttackTarget(Sample _target) {
+        peak = _target;
+    };
+
+    void setDecayRate(Sample rate) {
         dRate = rate;
     };
 
-    void setSustain(float level) {
+    void setSustain(Sample level) {
         sustain = level;
     };
 
-    void setRelease(float rate) {
+    void setRelease(Sample rate) {
         rRate = rate;
         rTime = -1;
     };
 
-    void setAttackTime(float time) {
+    void setAttackTime(Sample time) {
         aRate = 1.0 / (time * srate);
     };
 
-    void setDecayTime(float time) {
+    void setDecayTime(Sample time) {
         dRate = (1 - sustain) / (time * srate);
     };
 
-    void setReleaseTime(float time) {
+    void setReleaseTime(Sample time) {
         rRate = sustain / (time * srate);
         rTime = time;
     };
 
-    void setAllTimes(float atk, float dcy, float sus, float rel) {
+    void setAllTimes(Sample atk, Sample dcy, Sample sus, Sample rel) {
+        // Sustain first, the decay rate depends on it
+        setSustain(sus);
         setAttackTime(atk);
         setDecayTime(dcy);
-        setSustain(sus);
         setReleaseTime(rel);
     };
 
-    void setTarget(float _target) {
-        target = _target;
-        setSustain(target);
-        if (cur < target) state = ATTACK;
-        if (cur > target) state = DECAY;
+    // Glides to a new sustain level
+    void setTarget(Sample _target) {
+        setSustain(_target);
+        if (cur < _target) startSegment(ATTACK, _target, aRate);
+        else startSegment(DECAY, _target, dRate);
     };
 
-    void setValue(float val) {
-        state = SUSTAIN;
-        target = val;
+    void setValue(Sample val) {
         cur = val;
         setSustain(val);
+        hold(SUSTAIN);
     };
 
     int getState() {
         return state;
     }
 
-    float processEnvelope() {
+    // Samples left in the current segment (0 while sustaining or idle)
+    int getRemaining() {
+        return remain;
+    }
+
+    // One sample
+    Sample processEnvelope() {
+        if (remain > 0) {
+            cur = cur*mul + add;
+            if (--remain == 0) nextSegment();
+        }
+        return cur;
+    };
+
+    /*
+     *  Name: process(Sample *out, int n)
+     *  Desc: Renders n envelope samples, a run per segment
+     */
+    void process(Sample *out, int n) {
+        render<false>(out, n);
+    };
+
+    /*
+     *  Name: apply(Sample *buf, int n)
+     *  Desc: Multiplies n samples by the envelope in place
+     */
+    void apply(Sample *buf, int n) {
+        render<true>(buf, n);
+    };
+
+private:
+    template <bool MULTIPLY>
+    void render(Sample *buf, int n) {
+        typedef SampleVec<Sample> V;
+        while (n > 0) {
+            if (remain == 0) {
+                // Sustain/idle: constant
+                typename V::type v = V::set1(cur);
+                int i = 0;
+                if (MULTIPLY && cur == 1.f) return;
+                for (; i + V::WIDTH <= n; i += V::WIDTH) V::store(buf + i, MULTIPLY ? V::load(buf + i)*v : v);
+                for (; i < n; i++) buf[i] = MULTIPLY ? buf[i]*cur : cur;
+                return;
+            }
+
+            int run = (remain < n) ? remain : n;
+            ramp<MULTIPLY>(buf, run);
+            buf += run;
+            n -= run;
+            if ((remain -= run) == 0) nextSegment();
+        }
+    };
+
+    // n samples of the recursion. Eight interleaved lanes (8/WIDTH vectors)
+    // each step by mul^8, so a sample doesn't wait on the one before it
+    template <bool MULTIPLY>
+    void ramp(Sample *buf, int n) {
+        typedef SampleVec<Sample> V;
+        const int W = V::WIDTH, NV = 8/V::WIDTH;
+        Sample c = cur, m = mul, a = add;
+        int i = 0;
+        if (n >= 16) {
+            Sample lane[8];
+            for (int k = 0; k < 8; k++) lane[k] = c = c*m + a;
+            typename V::type v[NV];
+            for (int k = 0; k < NV; k++) v[k] = V::load(lane + k*W);
+
+            Sample m2 = m*m, m4 = m2*m2;
+            typename V::type M = V::set1(m4*m4), A = V::set1(a*(1.f + m)*(1.f + m2)*(1.f + m4));
+            for (; i + 8 <= n; i += 8) {
+                for (int k = 0; k < NV; k++)
+                    V::store(buf + i + k*W, MULTIPLY ? V::load(buf + i + k*W)*v[k] : v[k]);
+                c = v[NV - 1][W - 1];
+                for (int k = 0; k < NV; k++) v[k] = v[k]*M + A;
+            }
+        }
+        for (; i < n; i++) {
+            c = c*m + a;
+            buf[i] = MULTIPLY ? buf[i]*c : c;
+        }
+        cur = c;
+    };
+
+    void init(Sample _srate) {
+        srate = _srate;
+        cur = goal = 0;
+        peak = 1.0;
+        aRate = dRate = 0.001;
+        rRate = 0.005;
+        rTime = -1.0;
+        sustain = 0.5;
+        curve = LINEAR;
+        hold(IDLE);
+    };
+
+    // Constant segment
+    void hold(int _state) {
+        state = _state;
+        remain = 0;
+        mul = 1.f;
+        add = 0.f;
+    };
+
+    // Ramps from cur to _goal over |distance|/rate samples (at once for rate <= 0)
+    void startSegment(int _state, Sample _goal, Sample rate) {
+        state = _state;
+        goal = _goal;
+        Sample dist = fabs(goal - cur);
+        if (dist == 0.f || rate <= 0.f) {
+            cur = goal;
+            nextSegment();
+            return;
+        }
+
+        Sample len = ceil(dist / rate);
+        remain = (len < ADSR_MAX_SEGMENT) ? (int)len : ADSR_MAX_SEGMENT;
+
+        if (curve == LINEAR) {
+            mul = 1.f;
+            add = (goal - cur) / remain;
+        }
+        else {
+            // One-pole towards goal + overshoot*(goal - cur), landing on goal after remain samples
+            Sample over = (state == ATTACK) ? ADSR_ATTACK_OVERSHOOT : ADSR_DECAY_OVERSHOOT;
+            Sample aim = goal + over*(goal - cur);
+            mul = (Sample)exp(log(over / (1.0 + over)) / remain);
+            add = (1.f - mul)*aim;
+        }
+    };
+
+    // Lands exactly on the goal and moves to what follows it
+    void nextSegment() {
+        cur = goal;
         switch (state) {
-            case ATTACK: {
-                cur += aRate;
-                if (cur >= target) {
-                    cur = target;
-                    target = sustain;
-                    state = DECAY;
-                }
+            case ATTACK:
+                startSegment(DECAY, sustain, dRate);
                 break;
-            }
-            
-            case DECAY: {
-                if (cur > sustain) {
-                    cur -= dRate;
-                    if (cur <= sustain) {
-                        cur = sustain;
-                        state = SUSTAIN;
-                    }
-                }
-                else {
-                    cur += dRate;
-                    if (cur >= sustain) {
-                        cur = sustain;
-                        state = SUSTAIN;
-                    }
-                }
+            case DECAY:
+                hold(SUSTAIN);
                 break;
-            }
-            
-            case RELEASE: {
-                cur -= rRate;
-                if (cur <= 0) {
-                    cur = 0;
-                    state = IDLE;
-                }
+            case RELEASE:
+                hold(IDLE);
+                break;
+            default:
+                hold(state);
                 break;
-            }
-            
         }
-    
-        return cur;
     };
 
-private:
-    int state;
-    float srate, cur, target, aRate, dRate, rRate, rTime, sustain;
+    int state, curve, remain;
+    Sample srate, cur, goal, peak, aRate, dRate, rRate, rTime, sustain;
+    Sample mul, add;        // Segment recursion: cur = cur*mul + add
 };
 
+typedef ADSRT<float> ADSR;
+
 #endif // ADSR_H
@@ -0,0 +1,340 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   BatchRender.h
+ *
+ *   Description:   Batch render over a parameter grid, against golden outputs
+ *                  Every waveform x filter type x cutoff x Q x block size case is
+ *                  rendered offline on a pool of worker threads, each through
+ *                  a renderer of its own (main.cpp: a ProcessChain, envelope and
+ *                  event queue driven by renderBlock, as live). Each case keeps
+ *                  a hash of its output, a coarse RMS contour and its cost per
+ *                  sample; a golden file of those is compared after a change.
+ *
+ *                  Golden file: one line per case
+ *                      wave filter cutoff q block hash ns/sample level[0..15] (dB)
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef BATCHRENDER_H
+#define BATCHRENDER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "OscGen.h"
+#include "BiquadFilter.h"
+#include "SessionLog.h"
+
+#define BATCH_SECONDS           0.25f           // Audio per case
+#define BATCH_NOTE_HZ           220.f           // Oscillator frequency
+#define BATCH_RELEASE_AT        0.75f           // Key off, fraction of the case
+#define BATCH_LEVELS            16              // RMS contour segments kept per case
+#define BATCH_FLOOR_DB          -120.f          // Contour floor
+#define BATCH_LEVEL_TOL         0.1f            // Max contour change that still matches (dB, --batch-tolerance)
+#define BATCH_COST_TOL          0.f             // Max cost ratio to the golden, over the median ratio (--batch-cost, 0 = ignore)
+#define BATCH_PASSES            5               // Renders per case, the fastest is its cost
+#define BATCH_MAX_LISTED        20              // Deviating cases printed
+
+// One grid point
+typedef struct {
+    int waveform;               // OscGen::WAVEFORM
+    int filter;                 // BiquadFilter::FILTER
+    float cutoff, q;
+    int block;                  // Frames per render call
+} BatchCase;
+
+typedef struct {
+    unsigned int hash;          // sessionHash() of the whole output
+    float nsPerSample;          // Fastest of BATCH_PASSES renders
+    float level[BATCH_LEVELS];  // RMS per segment (dB)
+    bool deterministic;         // Every render hashed the same
+} BatchResult;
+
+// Renders cases for one worker: open() makes its state on the worker thread
+// (sized for blocks up to maxBlock), render() fills out with n samples of a
+// case from a cold start, close() frees the state
+typedef struct {
+    void *(*open)(int maxBlock);
+    void (*render)(void *self, const BatchCase *c, float *out, int n);
+    void (*close)(void *self);
+} BatchRenderer;
+
+static const char *batchWaveNames[] = { "sin", "saw", "tri", "sqr", "white", "pink", "additive" };
+static const char *batchFilterNames[] = { "fo_lpf", "fo_hpf", "-", "so_lpf", "so_hpf", "so_bpf", "so_bsf",
+                                          "so_lpf_butters", "so_hpf_butters", "so_bpf_butters", "so_bsf_butters" };
+
+class BatchGrid {
+public:
+    // Initializations (every waveform and filter type)
+    BatchGrid() {
+        for (int w = OscGen::SIN; w <= OscGen::ADDITIVE; w++) waves.push_back(w);
+        for (int f = BiquadFilter::FO_LPF; f <= BiquadFilter::SO_BSF_BUTTERS; f++)
+            if (f != 2) filters.push_back(f);
+        float fc[] = { 200.f, 1000.f, 5000.f, 15000.f }, q[] = { 0.707f, 2.f, 12.f };
+        int b[] = { 64, 256, 1024 };
+        cutoffs.assign(fc, fc + 4);
+        qs.assign(q, q + 3);
+        blocks.assign(b, b + 3);
+    };
+
+    /*
+     *  Name: set(const char *arg)
+     *  Desc: name=v1,v2,... replaces one axis (wave, filter, cutoff, q, block)
+     */
+    bool set(const char *arg) {
+        const char *eq = strchr(arg, '=');
+        if (eq == NULL || eq[1] == '\0') return false;
+        std::string name(arg, eq - arg);
+
+        std::vector<float> v;
+        for (const char *p = eq + 1; *p; ) {
+            char *end;
+            v.push_back(strtof(p, &end));
+            if (end == p || (*end != ',' && *end != '\0')) return false;
+            p = (*end == ',') ? end + 1 : end;
+        }
+
+        if (name == "wave") return setInts(&waves, v, OscGen::SIN, OscGen::ADDITIVE);
+        if (name == "filter") {
+            for (unsigned int i = 0; i < v.size(); i++) if (v[i] == 2) return false;   // no type 2
+            return setInts(&filters, v, BiquadFilter::FO_LPF, BiquadFilter::SO_BSF_BUTTERS);
+        }
+        if (name == "block") return setInts(&blocks, v, 1, 1 << 16);
+        if (name == "cutoff") cutoffs = v;
+        else if (name == "q") qs = v;
+        else return false;
+        return true;
+    };
+
+    // Every combination
+    void expand(std::vector<BatchCase> *cases) {
+        cases->clear();
+        for (unsigned int w = 0; w < waves.size(); w++)
+        for (unsigned int f = 0; f < filters.size(); f++)
+        for (unsigned int c = 0; c < cutoffs.size(); c++)
+        for (unsigned int q = 0; q < qs.size(); q++)
+        for (unsigned int b = 0; b < blocks.size(); b++) {
+            BatchCase bc = { waves[w], filters[f], cutoffs[c], qs[q], blocks[b] };
+            cases->push_back(bc);
+        }
+    };
+
+    void print() {
+        printf("%u waveforms x %u filters x %u cutoffs x %u Q x %u block sizes",
+                (unsigned int)waves.size(), (unsigned int)filters.size(), (unsigned int)cutoffs.size(),
+                (unsigned int)qs.size(), (unsigned int)blocks.size());
+    };
+
+private:
+    static bool setInts(std::vector<int> *axis, const std::vector<float> &v, int lo, int hi) {
+        for (unsigned int i = 0; i < v.size(); i++) if (v[i] < lo || v[i] > hi) return false;
+        axis->assign(v.begin(), v.end());
+        return true;
+    };
+
+    std::vector<int> waves, filters, blocks;
+    std::vector<float> cutoffs, qs;
+};
+
+/*
+ *  Name: batchMeasure(const BatchRenderer *renderer, void *self, const BatchCase *c, float *out, int n, BatchResult *r)
+ *  Desc: Renders a case BATCH_PASSES times (cost is the fastest) and fills
+ *        in its result
+ */
+inline void batchMeasure(const BatchRenderer *renderer, void *self, const BatchCase *c, float *out, int n, BatchResult *r) {
+    double best = 1e30;
+    r->deterministic = true;
+    for (int pass = 0; pass < BATCH_PASSES; pass++) {
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        renderer->render(self, c, out, n);
+        double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        if (t < best) best = t;
+
+        unsigned int h = sessionHash(out, n);
+        if (pass == 0) r->hash = h;
+        else if (h != r->hash) r->deterministic = false;
+    }
+    r->nsPerSample = (float)(best*1e9/n);
+
+    int seg = n/BATCH_LEVELS;
+    for (int k = 0; k < BATCH_LEVELS; k++) {
+        double sum = 0;
+        for (int i = k*seg; i < (k + 1)*seg; i++) sum += (double)out[i]*out[i];
+        float db = (float)(10*log10(sum/seg + 1e-30));
+        r->level[k] = (db > BATCH_FLOOR_DB) ? db : BATCH_FLOOR_DB;
+    }
+}
+
+/*
+ *  Name: batchRun(const std::vector<BatchCase> &cases, float srate, int threads, const BatchRenderer *renderer, std::vector<BatchResult> *results)
+ *  Desc: Renders every case on a pool of threads, each with its own renderer
+ *        state and taking the next unclaimed case until none are left.
+ *        srate is the renderer's rate (BATCH_SECONDS of audio per case).
+ */
+inline void batchRun(const std::vector<BatchCase> &cases, float srate, int threads, const BatchRenderer *renderer,
+                     std::vector<BatchResult> *results) {
+    int n = (int)(BATCH_SECONDS*srate);
+    int maxBlock = 1;
+    for (unsigned int i = 0; i < cases.size(); i++) if (cases[i].block > maxBlock) maxBlock = cases[i].block;
+    results->resize(cases.size());
+    std::atomic<unsigned int> next(0);
+
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++) {
+        pool.push_back(std::thread([&]() {
+            void *self = renderer->open(maxBlock);
+            std::vector<float> out(n);
+            unsigned int i;
+            while ((i = next.fetch_add(1)) < cases.size())
+                batchMeasure(renderer, self, &cases[i], &out[0], n, &(*results)[i]);
+            renderer->close(self);
+        }));
+    }
+    for (int t = 0; t < threads; t++) pool[t].join();
+}
+
+// Golden file key: everything that identifies a case
+inline std::string batchKey(const BatchCase *c) {
+    char key[96];
+    snprintf(key, sizeof(key), "%d %d %g %g %d", c->waveform, c->filter, c->cutoff, c->q, c->block);
+    return key;
+}
+
+/*
+ *  Name: batchWriteGolden(const char *path, const std::vector<BatchCase> &cases, const std::vector<BatchResult> &results)
+ *  Desc: One line per case, false if the file can't be written
+ */
+inline bool batchWriteGolden(const char *path, const std::vector<BatchCase> &cases, const std::vector<BatchResult> &results) {
+    FILE *f = fopen(path, "w");
+    if (f == NULL) return false;
+    fprintf(f, "# wave filter cutoff q block hash ns/sample level[%d] (dB)\n", BATCH_LEVELS);
+    for (unsigned int i = 0; i < cases.size(); i++) {
+        fprintf(f, "%s %08x %.2f", batchKey(&cases[i]).c_str(), results[i].hash, results[i].nsPerSample);
+        for (int k = 0; k < BATCH_LEVELS; k++) fprintf(f, " %.3f", results[i].level[k]);
+        fprintf(f, "\n");
+    }
+    return fclose(f) == 0;
+}
+
+/*
+ *  Name: batchReadGolden(const char *path, std::map<std::string, BatchResult> *golden)
+ *  Desc: Golden results by case key, false if the file can't be opened or
+ *        holds no cases
+ */
+inline bool batchReadGolden(const char *path, std::map<std::string, BatchResult> *golden) {
+    FILE *f = fopen(path, "r");
+    if (f == NULL) return false;
+
+    char line[512];
+    while (fgets(line, sizeof(line), f) != NULL) {
+        BatchCase c;
+        BatchResult r;
+        int used;
+        if (line[0] == '#' || sscanf(line, "%d %d %f %f %d %x %f%n", &c.waveform, &c.filter, &c.cutoff, &c.q,
+                                     &c.block, &r.hash, &r.nsPerSample, &used) != 7) continue;
+        char *p = line + used;
+        for (int k = 0; k < BATCH_LEVELS; k++) r.level[k] = strtof(p, &p);
+        r.deterministic = true;
+        (*golden)[batchKey(&c)] = r;
+    }
+    fclose(f);
+    return !golden->empty();
+}
+
+/*
+ *  Name: batchCompare(const std::vector<BatchCase> &cases, const std::vector<BatchResult> &results, const std::map<std::string, BatchResult> &golden, float levelTol, float costTol)
+ *  Desc: Prints the cases whose contour moved more than levelTol dB, or which
+ *        render differently each time, then a summary. True when none did.
+ *        Cost only counts when asked for (costTol > 0): a case more than
+ *        costTol times its golden cost, relative to the median case so a slower
+ *        or busier machine moves every case alike, fails too. Per-case timings
+ *        are noisy, so that is for quiet machines.
+ */
+inline bool batchCompare(const std::vector<BatchCase> &cases, const std::vector<BatchResult> &results,
+                         const std::map<std::string, BatchResult> &golden, float levelTol, float costTol) {
+    std::vector<float> ratios;
+    for (unsigned int i = 0; i < cases.size(); i++) {
+        std::map<std::string, BatchResult>::const_iterator g = golden.find(batchKey(&cases[i]));
+        if (g != golden.end()) ratios.push_back(results[i].nsPerSample/g->second.nsPerSample);
+    }
+    float median = 1.f;
+    if (!ratios.empty()) {
+        std::nth_element(ratios.begin(), ratios.begin() + ratios.size()/2, ratios.end());
+        median = ratios[ratios.size()/2];
+    }
+
+    int exact = 0, close = 0, deviate = 0, slower = 0, unstable = 0, added = 0, listed = 0;
+    for (unsigned int i = 0; i < cases.size(); i++) {
+        const BatchCase *c = &cases[i];
+        const BatchResult *r = &results[i];
+        std::map<std::string, BatchResult>::const_iterator g = golden.find(batchKey(c));
+        if (g == golden.end()) {
+            added++;
+            continue;
+        }
+
+        float worst = 0.f;
+        int at = 0;
+        for (int k = 0; k < BATCH_LEVELS; k++) {
+            float d = fabsf(r->level[k] - g->second.level[k]);
+            if (d > worst) {
+                worst = d;
+                at = k;
+            }
+        }
+        float ratio = r->nsPerSample/g->second.nsPerSample/median;
+
+        const char *what = NULL;
+        char detail[64] = "";
+        if (!r->deterministic) {
+            unstable++;
+            what = "UNSTABLE";
+            snprintf(detail, sizeof(detail), "two renders differ");
+        }
+        else if (r->hash == g->second.hash) exact++;
+        else if (worst <= levelTol) close++;
+        else {
+            deviate++;
+            what = "DEVIATES";
+            snprintf(detail, sizeof(detail), "%.2f dB at segment %d", worst, at);
+        }
+        if (costTol > 0 && ratio > costTol) {
+            slower++;
+            if (what == NULL) {
+                what = "SLOWER";
+                snprintf(detail, sizeof(detail), "%.1f ns/sample, was %.1f (%.2fx the median)",
+                         r->nsPerSample, g->second.nsPerSample, ratio);
+            }
+        }
+
+        if (what != NULL && listed++ < BATCH_MAX_LISTED)
+            printf("[batch]: %-8s %-8s %-14s %6g Hz Q %-5g block %-5d %s\n", what, batchWaveNames[c->waveform],
+                    batchFilterNames[c->filter], c->cutoff, c->q, c->block, detail);
+    }
+    if (listed > BATCH_MAX_LISTED) printf("[batch]: ... %d more\n", listed - BATCH_MAX_LISTED);
+
+    printf("[batch]: %d bit-exact, %d within %.2f dB, %d deviate, %d unstable, %d not in golden\n",
+            exact, close, levelTol, deviate, unstable, added);
+    if (costTol > 0) printf("[batch]: %d slower than %.2fx\n", slower, costTol);
+    printf("[batch]: median cost %.2fx the golden\n", median);
+    return deviate == 0 && unstable == 0 && slower == 0;
+}
+
+#endif // BATCHRENDER_H
@@ -0,0 +1,841 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   Benchmark.h
+ *
+ *   Description:   Offline benchmarks for the DSP classes
+ *                  Run with ./main --bench <name>, no audio device or window needed
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+#include "Resampler.h"
+#include "IIRDesign.h"
+#include "SOSCascade.h"
+#include "Persistence.h"
+#include "FastMath.h"
+#include "ADSR.h"
+#include "Additive.h"
+#include "SincDisplay.h"
+#include "BiquadFilter.h"
+#include "OscGen.h"
+#include "SVFilter.h"
+
+/*
+ *  Name: benchNow()
+ *  Desc: Monotonic time in seconds
+ */
+static inline double benchNow() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+ *  Name: toneSNR(const float *x, int n, double freq, double srate)
+ *  Desc: Fits a sine at freq by least squares and returns signal/residual in dB
+ */
+static inline double toneSNR(const float *x, int n, double freq, double srate) {
+    double ss = 0, sc = 0, cc = 0, xs = 0, xc = 0;
+    for (int i = 0; i < n; i++) {
+        double s = sin(2.0*M_PI*freq*i/srate), c = cos(2.0*M_PI*freq*i/srate);
+        ss += s*s; sc += s*c; cc += c*c;
+        xs += x[i]*s; xc += x[i]*c;
+    }
+    double det = ss*cc - sc*sc;
+    double a = (xs*cc - xc*sc)/det, b = (xc*ss - xs*sc)/det;
+
+    double sig = 0, err = 0;
+    for (int i = 0; i < n; i++) {
+        double fit = a*sin(2.0*M_PI*freq*i/srate) + b*cos(2.0*M_PI*freq*i/srate);
+        sig += fit*fit;
+        err += (x[i] - fit)*(x[i] - fit);
+    }
+    return 10.0*log10(sig/(err + 1e-30));
+}
+
+/*
+ *  Name: benchResampler()
+ *  Desc: Cost (ns/output sample) and quality per setting
+ *        SNR: 1kHz tone against a least squares sine fit
+ *        hf: gain of a tone above the output Nyquist when downsampling (should be
+ *            very negative), or at 0.4 of the input rate when upsampling (should be ~0)
+ */
+static inline void benchResampler() {
+    static const double rates[][2] = { { 44100, 48000 }, { 48000, 44100 }, { 44100, 96000 }, { 96000, 44100 } };
+    static const int taps[] = { 8, 16, 32, 64 };
+    const int block = 1024;
+    const int seconds = 4;
+
+    printf("%-16s %5s %12s %10s %10s\n", "ratio", "taps", "ns/sample", "SNR(dB)", "hf(dB)");
+    for (unsigned int r = 0; r < sizeof(rates)/sizeof(rates[0]); r++) {
+        double inRate = rates[r][0], outRate = rates[r][1];
+        int total = (int)(seconds*inRate);
+        std::vector<float> in(total), out((size_t)(total*outRate/inRate) + block*4);
+        std::vector<float> alias(total), aliasOut(out.size());
+
+        // 1kHz tone, and a tone in the stopband (downsampling) or upper passband (upsampling)
+        double stopFreq = (outRate < inRate) ? 0.55*outRate : 0.4*inRate;
+        for (int i = 0; i < total; i++) {
+            in[i] = (float)(0.5*sin(2.0*M_PI*1000.0*i/inRate));
+            alias[i] = (float)(0.5*sin(2.0*M_PI*stopFreq*i/inRate));
+        }
+
+        for (unsigned int t = 0; t < sizeof(taps)/sizeof(taps[0]); t++) {
+            Resampler rs(inRate, outRate, taps[t], 256, block);
+            int n = 0;
+            double t0 = benchNow();
+            for (int i = 0; i + block <= total; i += block)
+                n += rs.process(&in[i], block, &out[n], out.size() - n);
+            double t1 = benchNow();
+
+            Resampler rs2(inRate, outRate, taps[t], 256, block);
+            int m = 0;
+            for (int i = 0; i + block <= total; i += block)
+                m += rs2.process(&alias[i], block, &aliasOut[m], aliasOut.size() - m);
+
+            // Skip the filter's warm-up before measuring
+            int skip = taps[t]*2;
+            double rms = 0;
+            for (int i = skip; i < m; i++) rms += aliasOut[i]*aliasOut[i];
+            rms = sqrt(rms/(m - skip));
+            double hf = 20.0*log10(rms/(0.5/sqrt(2.0)) + 1e-12);
+
+            char label[32];
+            snprintf(label, sizeof(label), "%.0f->%.0f", inRate, outRate);
+            printf("%-16s %5d %12.2f %10.1f %10.1f\n", label, rs.getTaps(),
+                    1e9*(t1 - t0)/n, toneSNR(&out[skip], n - skip, 1000.0, outRate), hf);
+        }
+    }
+}
+
+/*
+ *  Name: benchIIR()
+ *  Desc: Cost (ns/sample) of the SOS cascade per family and order, in DF1 and TDF2
+ *        float, and TDF2 double (f64) with double sections
+ *        err: output against a long double run of the double sections, so the
+ *        float columns include the rounding of the coefficients
+ *        stop: worst gain from twice the cutoff up to Nyquist
+ */
+static inline void benchIIR() {
+    static const char *families[] = { "butterworth", "chebyshev1", "chebyshev2", "elliptic" };
+    static const int orders[] = { 2, 4, 8, 16, 32 };
+    const double srate = 44100, fc = 500;
+    const int block = 256;
+    const int total = block*344;       // ~2 seconds
+
+    // White noise input
+    std::vector<float> in(total), out(total);
+    std::vector<double> ref(total), out64(total);
+    std::vector<long double> acc(total);
+    unsigned int seed = 22222;
+    for (int i = 0; i < total; i++) {
+        seed = seed * 1103515245u + 12345u;
+        in[i] = (float)((seed >> 8)/8388608.0 - 1.0)*0.5f;
+    }
+
+    printf("lowpass %.0f Hz, 1 dB ripple, 60 dB stopband\n", fc);
+    printf("%-12s %5s %8s %10s %10s %10s %10s %10s %10s %10s\n", "family", "order", "sections",
+            "DF1 ns", "TDF2 ns", "f64 ns", "DF1 err", "TDF2 err", "f64 err", "stop(dB)");
+    for (int f = 0; f < 4; f++) {
+        for (unsigned int o = 0; o < sizeof(orders)/sizeof(orders[0]); o++) {
+            SOSSection sos[SOS_MAX_SECTIONS];
+            SOSSectionT<double> sos64[SOS_MAX_SECTIONS];
+            int n = IIRDesign::design(f, IIRDesign::LOWPASS, orders[o], srate, fc, 0, 1, 60, sos, SOS_MAX_SECTIONS);
+            if (n == 0) continue;
+            IIRDesign::design(f, IIRDesign::LOWPASS, orders[o], srate, fc, 0, 1, 60, sos64, SOS_MAX_SECTIONS);
+
+            // Extended precision reference
+            for (int i = 0; i < total; i++) acc[i] = in[i];
+            for (int s = 0; s < n; s++) {
+                long double x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+                for (int i = 0; i < total; i++) {
+                    long double y = sos64[s].b0*acc[i] + sos64[s].b1*x1 + sos64[s].b2*x2 - sos64[s].a1*y1 - sos64[s].a2*y2;
+                    x2 = x1; x1 = acc[i];
+                    y2 = y1; y1 = y;
+                    acc[i] = y;
+                }
+            }
+            for (int i = 0; i < total; i++) ref[i] = (double)acc[i];
+
+            double ns[3], err[3];
+            for (int form = SOSCascade::DF1; form <= SOSCascade::TDF2; form++) {
+                SOSCascade cascade;
+                cascade.setSections(sos, n);
+                cascade.setForm(form);
+
+                // Warm up once, then time from a cleared state
+                out = in;
+                for (int i = 0; i + block <= total; i += block) cascade.processBlock(&out[i], block);
+                cascade.reset();
+
+                out = in;
+                double t0 = benchNow();
+                for (int i = 0; i + block <= total; i += block) cascade.processBlock(&out[i], block);
+                ns[form] = 1e9*(benchNow() - t0)/total;
+
+                double e = 0, sig = 0;
+                for (int i = 0; i < total; i++) {
+                    e += (out[i] - ref[i])*(out[i] - ref[i]);
+                    sig += ref[i]*ref[i];
+                }
+                err[form] = 10.0*log10(e/(sig + 1e-30) + 1e-30);
+            }
+
+            // Double sections and state, same timing and error
+            SOSCascadeT<double> cascade64;
+            cascade64.setSections(sos64, n);
+            for (int i = 0; i < total; i++) out64[i] = in[i];
+            for (int i = 0; i + block <= total; i += block) cascade64.processBlock(&out64[i], block);
+            cascade64.reset();
+
+            for (int i = 0; i < total; i++) out64[i] = in[i];
+            double t0 = benchNow();
+            for (int i = 0; i + block <= total; i += block) cascade64.processBlock(&out64[i], block);
+            ns[2] = 1e9*(benchNow() - t0)/total;
+
+            double e = 0, sig = 0;
+            for (int i = 0; i < total; i++) {
+                e += (out64[i] - ref[i])*(out64[i] - ref[i]);
+                sig += ref[i]*ref[i];
+            }
+            err[2] = 10.0*log10(e/(sig + 1e-30) + 1e-30);
+
+            double stop = -1e9;
+            for (double freq = 2*fc; freq < srate/2; freq += 10)
+                stop = fmax(stop, 20.0*log10(std::abs(IIRDesign::response(sos, n, freq, srate)) + 1e-30));
+
+            printf("%-12s %5d %8d %10.2f %10.2f %10.2f %10.1f %10.1f %10.1f %10.1f\n", families[f], orders[o], n,
+                    ns[0], ns[1], ns[2], err[0], err[1], err[2], stop);
+        }
+    }
+}
+
+/*
+ *  Name: benchPersistence()
+ *  Desc: Waveforms per second binned into a 512 x 256 persistence histogram,
+ *        for several waveform lengths and worker counts
+ */
+static inline void benchPersistence() {
+    static const int spans[] = { 256, 1024 };
+    static const int threads[] = { 1, 2, 4, 8 };
+    const int len = 1 << 16, batch = 4096;
+
+    // Noisy sine with a glitch every so often, and random trigger points
+    std::vector<float> sig(len + 1024);
+    std::vector<int> starts(batch);
+    unsigned int seed = 22222;
+    for (unsigned int i = 0; i < sig.size(); i++) {
+        seed = seed * 1103515245u + 12345u;
+        sig[i] = 0.8f*sinf(2.f*M_PI*440.f*i/44100.f) + 0.05f*((seed >> 8)/8388608.f - 1.f);
+        if (i % 9973 == 0) sig[i] = -0.95f;
+    }
+    for (int k = 0; k < batch; k++) {
+        seed = seed * 1103515245u + 12345u;
+        starts[k] = (seed >> 8) % len;
+    }
+
+    printf("%6s %8s %14s %14s\n", "span", "threads", "waveforms/s", "Msamples/s");
+    for (unsigned int s = 0; s < sizeof(spans)/sizeof(spans[0]); s++) {
+        for (unsigned int t = 0; t < sizeof(threads)/sizeof(threads[0]); t++) {
+            Persistence p(512, 256, spans[s], threads[t]);
+            p.accumulate(&sig[0], &starts[0], batch);
+
+            // Batches until half a second has passed, decaying as the display would
+            int batches = 0;
+            double t0 = benchNow(), elapsed = 0;
+            while (elapsed < 0.5) {
+                p.decay(0.92f);
+                p.accumulate(&sig[0], &starts[0], batch);
+                batches++;
+                elapsed = benchNow() - t0;
+            }
+
+            double rate = (double)batches*batch/elapsed;
+            printf("%6d %8d %14.0f %14.1f\n", spans[s], threads[t], rate, rate*spans[s]/1e6);
+        }
+    }
+}
+
+// Error of one approximation against the double-precision libm result
+struct FastMathError {
+    double ulp, abs, rel, db;
+};
+
+// Relative measures (ulp, relative, dB) skip results near zero, where they say little
+static inline void fastMathError(FastMathError *e, float approx, double exact) {
+    double err = fabs((double)approx - exact);
+    if (err > e->abs) e->abs = err;
+    if (fabs(exact) > 1e-3) {
+        float ref = fabsf((float)exact);
+        double ulp = err/(nextafterf(ref, INFINITY) - ref);
+        double rel = err/fabs(exact);
+        double db = fabs(20.0*log10(fabs(approx/exact)));
+        if (ulp > e->ulp) e->ulp = ulp;
+        if (rel > e->rel) e->rel = rel;
+        if (db > e->db) e->db = db;
+    }
+}
+
+/*
+ *  Name: benchFastMathKernel(...)
+ *  Desc: Max error over the inputs, and ns per value (best of three runs) for
+ *        the scalar form and the four-lane kernel; false past the level's bound
+ */
+template <int L>
+static inline bool benchFastMathKernel(const char *name, int func, const float *x, const float *y, int n, double libmNs) {
+    FastMathError e = { 0, 0, 0, 0 };
+    for (int i = 0; i < n; i++) {
+        switch (func) {
+            case 0: fastMathError(&e, fastSin<L>(x[i]), sin((double)x[i])); break;
+            case 1: fastMathError(&e, fastCos<L>(x[i]), cos((double)x[i])); break;
+            case 2: fastMathError(&e, fastTan<L>(x[i]), tan((double)x[i])); break;
+            case 3: fastMathError(&e, fastExp2<L>(x[i]), exp2((double)x[i])); break;
+            case 4: fastMathError(&e, fastLog2<L>(x[i]), log2((double)x[i])); break;
+            case 5: fastMathError(&e, fastTanh<L>(x[i]), tanh((double)x[i])); break;
+            case 6: fastMathError(&e, fastPow<L>(x[i], y[i]), pow((double)x[i], (double)y[i])); break;
+        }
+    }
+
+    // Timing: summed so the loops aren't optimized away
+    float acc = 0.f;
+    v4sf vacc = v4set1(0.f);
+    double scalarNs = 1e9, vectorNs = 1e9;
+    for (int run = 0; run < 3; run++) {
+        double t0 = benchNow();
+        for (int i = 0; i < n; i++) {
+            switch (func) {
+                case 0: acc += fastSin<L>(x[i]); break;
+                case 1: acc += fastCos<L>(x[i]); break;
+                case 2: acc += fastTan<L>(x[i]); break;
+                case 3: acc += fastExp2<L>(x[i]); break;
+                case 4: acc += fastLog2<L>(x[i]); break;
+                case 5: acc += fastTanh<L>(x[i]); break;
+                case 6: acc += fastPow<L>(x[i], y[i]); break;
+            }
+        }
+        double t1 = benchNow();
+        for (int i = 0; i + 4 <= n; i += 4) {
+            v4sf v = v4load(x + i);
+            switch (func) {
+                case 0: vacc += v4sin<L>(v); break;
+                case 1: vacc += v4cos<L>(v); break;
+                case 2: vacc += v4tan<L>(v); break;
+                case 3: vacc += v4exp2<L>(v); break;
+                case 4: vacc += v4log2<L>(v); break;
+                case 5: vacc += v4tanh<L>(v); break;
+                case 6: vacc += v4pow<L>(v, v4load(y + i)); break;
+            }
+        }
+        double t2 = benchNow();
+        scalarNs = fmin(scalarNs, (t1 - t0)*1e9/n);
+        vectorNs = fmin(vectorNs, (t2 - t1)*1e9/n);
+    }
+    volatile float sink = acc + v4sum(vacc);
+    (void)sink;
+
+    static const char *levels[] = { "fast", "normal", "precise" };
+    static const double bounds[] = { FM_FAST_MAX_REL, FM_NORMAL_MAX_REL, FM_PRECISE_MAX_REL };
+    bool ok = e.rel <= bounds[L];
+    printf("%-6s %-8s %12.1f %12.3g %10.2g %10.2g %9.2f %9.2f %9.2f %8.1fx %s\n", name, levels[L],
+           e.ulp, e.abs, e.rel, e.db, libmNs, scalarNs, vectorNs, libmNs/vectorNs, ok ? "ok" : "FAIL");
+    return ok;
+}
+
+/*
+ *  Name: benchFastMath()
+ *  Desc: Accuracy of every FastMath kernel at every level against libm (max
+ *        ulp, absolute, relative and dB error) and its speed against the libm
+ *        float call; false if any level exceeds its documented bound
+ */
+static inline bool benchFastMath() {
+    static const char *names[] = { "sin", "cos", "tan", "exp2", "log2", "tanh", "pow" };
+    const int n = 1 << 20;
+    std::vector<float> x(n), y(n);
+
+    bool ok = true;
+
+    printf("(ulp, relative and dB over results above 1e-3 in magnitude, absolute over all; speedup is v4 vs libm)\n");
+    printf("%-6s %-8s %12s %12s %10s %10s %9s %9s %9s %9s\n", "func", "level", "max ulp", "max abs", "max rel",
+           "max dB", "libm ns", "scalar ns", "v4 ns", "speedup");
+    for (int func = 0; func < 7; func++) {
+        // Domains: eight turns of phase, tan below its poles, 40 octaves, 12 decades,
+        // the whole tanh knee, pow as used for pitch and gain
+        for (int i = 0; i < n; i++) {
+            float u = (float)i/n;
+            switch (func) {
+                case 0: case 1: x[i] = 16.f*M_PI*(u - 0.5f); break;
+                case 2: x[i] = 2.9f*(u - 0.5f); break;
+                case 3: x[i] = 40.f*(u - 0.5f); break;
+                case 4: x[i] = powf(10.f, 12.f*(u - 0.5f)); break;
+                case 5: x[i] = 10.f*(u - 0.5f); break;
+                case 6: x[i] = 0.01f + 10.f*u; y[i] = 8.f*((float)((i*7919u) % n)/n - 0.5f); break;
+            }
+        }
+
+        float acc = 0.f;
+        double libmNs = 1e9;
+        for (int run = 0; run < 3; run++) {
+            double t0 = benchNow();
+            for (int i = 0; i < n; i++) {
+                switch (func) {
+                    case 0: acc += sinf(x[i]); break;
+                    case 1: acc += cosf(x[i]); break;
+                    case 2: acc += tanf(x[i]); break;
+                    case 3: acc += exp2f(x[i]); break;
+                    case 4: acc += log2f(x[i]); break;
+                    case 5: acc += tanhf(x[i]); break;
+                    case 6: acc += powf(x[i], y[i]); break;
+                }
+            }
+            libmNs = fmin(libmNs, (benchNow() - t0)*1e9/n);
+        }
+        volatile float sink = acc;
+        (void)sink;
+
+        ok &= benchFastMathKernel<FM_FAST>(names[func], func, &x[0], &y[0], n, libmNs);
+        ok &= benchFastMathKernel<FM_NORMAL>(names[func], func, &x[0], &y[0], n, libmNs);
+        ok &= benchFastMathKernel<FM_PRECISE>(names[func], func, &x[0], &y[0], n, libmNs);
+    }
+    if (!ok) printf("[bench]: FAIL, error above the documented bound\n");
+    return ok;
+}
+
+/*
+ *  Name: benchADSRPrepare(ADSR *env, int curve, int segment)
+ *  Desc: One voice parked in the given segment, with segments longer than the run
+ */
+static inline void benchADSRPrepare(ADSR *env, int curve, int segment) {
+    static float scratch[4096];
+    *env = ADSR(44100.f);
+    env->setCurve(curve);
+    env->setValue(0.f);
+    if (segment == ADSR::ATTACK) {
+        env->setAllTimes(5.f, 5.f, 0.5f, 5.f);
+        env->keyOn();
+        return;
+    }
+    env->setAllTimes(0.01f, 0.01f, 0.5f, 5.f);
+    env->keyOn();
+    env->process(scratch, 4096);
+    if (segment == ADSR::RELEASE) env->keyOff();
+}
+
+/*
+ *  Name: benchADSR()
+ *  Desc: Envelope cost per voice and sample, one processEnvelope() call per sample
+ *        against process() on whole blocks, in ramp and sustain segments
+ */
+static inline void benchADSR() {
+    static const int segments[] = { ADSR::ATTACK, ADSR::SUSTAIN, ADSR::RELEASE };
+    static const char *segmentNames[] = { "attack", "sustain", "release" };
+    static const char *curveNames[] = { "linear", "exp" };
+    const int voices = 256, block = 256, blocks = 512;
+    std::vector<ADSR> env(voices);
+    std::vector<float> out(block);
+    volatile float sink = 0.f;
+
+    printf("%d voices, %d-sample blocks, ns per voice-sample\n", voices, block);
+    printf("%-10s %-8s %12s %12s %10s\n", "segment", "curve", "per-sample", "block", "speedup");
+    for (int c = 0; c < 2; c++) {
+        for (int s = 0; s < 3; s++) {
+            for (int v = 0; v < voices; v++) benchADSRPrepare(&env[v], c, segments[s]);
+            double t0 = benchNow();
+            for (int b = 0; b < blocks; b++) {
+                for (int v = 0; v < voices; v++) {
+                    for (int i = 0; i < block; i++) out[i] = env[v].processEnvelope();
+                    sink = out[block - 1];
+                }
+            }
+            double sampleNs = (benchNow() - t0)*1e9/((double)blocks*voices*block);
+
+            for (int v = 0; v < voices; v++) benchADSRPrepare(&env[v], c, segments[s]);
+            t0 = benchNow();
+            for (int b = 0; b < blocks; b++) {
+                for (int v = 0; v < voices; v++) {
+                    env[v].process(&out[0], block);
+                    sink = out[block - 1];
+                }
+            }
+            double blockNs = (benchNow() - t0)*1e9/((double)blocks*voices*block);
+
+            printf("%-10s %-8s %12.3f %12.3f %9.1fx\n", segmentNames[s], curveNames[c],
+                   sampleNs, blockNs, sampleNs/blockNs);
+        }
+    }
+    (void)sink;
+}
+
+/*
+ *  Name: benchAdditive()
+ *  Desc: Additive bank error against a double-precision sum of sines, amplitude
+ *        drift over a long run, band limiting, and cost per partial count
+ */
+static inline void benchAdditive() {
+    const float srate = 44100.f, f0 = 55.f;
+    const int seconds = 10, check = 4096;
+
+    // Accuracy: 64 slightly inharmonic partials against the exact sum
+    Additive bank(srate);
+    bank.setSawtooth(0);
+    for (int k = 0; k < 64; k++) bank.setPartial(k, (k + 1)*1.0013f, 1.f/(k + 1));
+    bank.setFrequency(f0);
+    bank.reset();
+
+    std::vector<float> out(seconds*(int)srate);
+    bank.render(&out[0], check);
+
+    double maxErr = 0, peak = 0;
+    for (int i = 0; i < check; i++) {
+        double exact = 0;
+        for (int k = 0; k < 64; k++)
+            exact += bank.getLevel(k)*sin(2*M_PI*(double)f0*bank.getRatio(k)*i/srate);
+        maxErr = fmax(maxErr, fabs(out[i] - exact));
+        peak = fmax(peak, fabs(exact));
+    }
+    printf("64 partials, first %d samples: max error %.2g (%.1f dB below peak)\n", check, maxErr, 20*log10(peak/maxErr));
+
+    // Drift: one unit partial after ten seconds (phase drift from float frequency
+    // rounding is inaudible, so only its level is checked)
+    Additive one(srate);
+    one.setSawtooth(0);
+    one.setPartial(0, 1.f, 1.f);
+    one.setFrequency(1000.f);
+    one.reset();
+    one.render(&out[0], (int)out.size());
+    float level = 0.f;
+    for (int i = (int)out.size() - check; i < (int)out.size(); i++) level = fmaxf(level, fabsf(out[i]));
+    printf("unit partial after %d s: level %.7f (%.2g dB)\n", seconds, level, 20*log10(level));
+
+    // Band limiting: a 512-partial sawtooth keeps only what fits below Nyquist
+    Additive saw(srate);
+    static const float notes[] = { 27.5f, 440.f, 3520.f };
+    for (int i = 0; i < 3; i++) {
+        saw.setFrequency(notes[i]);
+        printf("sawtooth at %6.1f Hz: %3d partials rendered\n", notes[i], saw.getActivePartials());
+    }
+
+    // Cost: all partials below Nyquist
+    static const int counts[] = { 32, 64, 128, 256, 512 };
+    const int block = 256, blocks = 2048;
+    printf("%9s %14s %16s %14s\n", "partials", "ns/sample", "ns/partial-smp", "voices (RT)");
+    for (unsigned int c = 0; c < sizeof(counts)/sizeof(counts[0]); c++) {
+        Additive voice(srate);
+        voice.setSawtooth(counts[c]);
+        voice.setFrequency(20.f);
+        voice.reset();
+        voice.render(&out[0], block);
+
+        double t0 = benchNow();
+        for (int b = 0; b < blocks; b++) voice.render(&out[0], block);
+        double ns = (benchNow() - t0)*1e9/((double)blocks*block);
+        printf("%9d %14.2f %16.3f %14.0f\n", counts[c], ns, ns/counts[c], 1e9/(ns*srate));
+    }
+}
+
+/*
+ *  Name: benchDisplay()
+ *  Desc: Scope trace reconstruction: error against the exact signal between
+ *        samples, true peak against sample peak, and cost per frame for
+ *        screen widths and zoom levels
+ */
+static inline void benchDisplay() {
+    const int n = 1024;
+    SincDisplay sinc;
+    std::vector<float> x(n), y(4096);
+
+    // Accuracy: sines up to 0.45 fs, 20 points per sample over 100 samples
+    const int points = 2000;
+    static const double freqs[] = { 0.01, 0.1, 0.25, 0.4, 0.45 };
+    printf("%d taps\n%10s %14s\n", sinc.getTaps(), "freq/fs", "max error dB");
+    for (unsigned int f = 0; f < sizeof(freqs)/sizeof(freqs[0]); f++) {
+        for (int i = 0; i < n; i++) x[i] = (float)sin(2*M_PI*freqs[f]*i + 0.3);
+        sinc.render(&x[0], n, n/4, 0.05, &y[0], points);
+        double maxErr = 0;
+        for (int j = 0; j < points; j++)
+            maxErr = fmax(maxErr, fabs(y[j] - sin(2*M_PI*freqs[f]*(n/4 + 0.05*j) + 0.3)));
+        printf("%10.2f %14.1f\n", freqs[f], 20*log10(maxErr));
+    }
+
+    // True peak: a full scale sine at fs/4 sampled 45 degrees off its peaks
+    for (int i = 0; i < n; i++) x[i] = (float)sin(M_PI/2*i + M_PI/4);
+    sinc.render(&x[0], n, n/2, 1.0/64, &y[0], 256);
+    float samplePeak = 0.f, truePeak = 0.f;
+    for (int i = n/2; i < n/2 + 4; i++) samplePeak = fmaxf(samplePeak, fabsf(x[i]));
+    for (int j = 0; j < 256; j++) truePeak = fmaxf(truePeak, fabsf(y[j]));
+    printf("fs/4 sine: sample peak %.2f dB, reconstructed peak %.3f dB (exact 0)\n",
+            20*log10(samplePeak), 20*log10(truePeak));
+
+    // Cost: one point per pixel column, whatever the zoom
+    static const int columns[] = { 845, 1920, 3840 };
+    static const int zooms[] = { 16, 128, 512 };
+    const int frames = 2000;
+    for (int i = 0; i < n; i++) x[i] = (float)sin(0.01*i);
+    printf("%9s %9s %12s %12s\n", "columns", "samples", "us/frame", "ns/column");
+    for (int c = 0; c < 3; c++) {
+        for (int z = 0; z < 3; z++) {
+            double t0 = benchNow();
+            for (int f = 0; f < frames; f++)
+                sinc.render(&x[0], n, (n - zooms[z])/2, (double)zooms[z]/columns[c], &y[0], columns[c]);
+            double us = (benchNow() - t0)*1e6/frames;
+            printf("%9d %9d %12.1f %12.2f\n", columns[c], zooms[z], us, 1e3*us/columns[c]);
+        }
+    }
+}
+
+/*
+ *  Name: benchPrecisionFilter(int type, float fc, float q, const float *x, int n, ...)
+ *  Desc: One filter type at one setting: ns/sample of processBlock() and error
+ *        against a long double reference, in float and double
+ */
+static inline void benchPrecisionFilter(const char *name, int type, float fc, float q, const float *x, int n,
+                                        float srate, std::vector<float> *out) {
+    const int block = 256;
+
+    BiquadFilterT<long double> ref(srate);
+    ref.setCutoffFrequency(fc);
+    ref.setQ(q);
+    ref.setFilterType(type);
+    std::vector<long double> y(n);
+    long double sig = 0;
+    for (int i = 0; i < n; i++) {
+        y[i] = ref.processBiquad(x[i]);
+        sig += y[i]*y[i];
+    }
+
+    double ns[2], err[2];
+    for (int p = 0; p < 2; p++) {
+        BiquadFilterT<float> f32(srate);
+        BiquadFilterT<double> f64(srate);
+        f32.setCutoffFrequency(fc); f32.setQ(q); f32.setFilterType(type);
+        f64.setCutoffFrequency(fc); f64.setQ(q); f64.setFilterType(type);
+
+        double t0 = benchNow();
+        for (int i = 0; i < n; i += block) {
+            int m = (n - i < block) ? n - i : block;
+            if (p == 0) f32.processBlock(x + i, &(*out)[i], m);
+            else f64.processBlock(x + i, &(*out)[i], m);
+        }
+        ns[p] = (benchNow() - t0)*1e9/n;
+
+        // Output rounding to float is common to both, it sets the floor
+        long double e = 0;
+        for (int i = 0; i < n; i++) e += ((*out)[i] - y[i])*((*out)[i] - y[i]);
+        err[p] = 10*log10((double)(e/sig) + 1e-30);
+    }
+    printf("%-16s %7.0f %5.1f %10.2f %10.2f %10.1f %10.1f\n", name, fc, q, ns[0], ns[1], err[0], err[1]);
+}
+
+/*
+ *  Name: benchPrecision()
+ *  Desc: Float against double BiquadFilter per type, at an easy setting and a
+ *        low-cutoff high-Q one, then OscGen and ADSR in both sample types
+ */
+static inline void benchPrecision() {
+    const float srate = 44100.f;
+    const int n = 2*(int)srate;
+    static const struct { const char *name; int type; } types[] = {
+        { "fo_lpf", BiquadFilter::FO_LPF }, { "fo_hpf", BiquadFilter::FO_HPF },
+        { "so_lpf", BiquadFilter::SO_LPF }, { "so_hpf", BiquadFilter::SO_HPF },
+        { "so_bpf", BiquadFilter::SO_BPF }, { "so_bsf", BiquadFilter::SO_BSF },
+        { "so_lpf_butters", BiquadFilter::SO_LPF_BUTTERS }, { "so_hpf_butters", BiquadFilter::SO_HPF_BUTTERS },
+        { "so_bpf_butters", BiquadFilter::SO_BPF_BUTTERS }, { "so_bsf_butters", BiquadFilter::SO_BSF_BUTTERS },
+    };
+
+    // Noise input (never exactly 0, which the biquad treats as silence)
+    std::vector<float> x(n), out(n);
+    unsigned int seed = 22222;
+    for (int i = 0; i < n; i++) {
+        seed = seed*1103515245u + 12345u;
+        x[i] = ((seed >> 8) + 0.5f)/8388608.f - 1.f;
+    }
+
+    printf("BiquadFilter, %d samples of noise in 256-sample blocks, error re a long double filter\n", n);
+    printf("%-16s %7s %5s %10s %10s %10s %10s\n", "type", "fc", "Q", "float ns", "double ns", "float dB", "double dB");
+    for (unsigned int t = 0; t < sizeof(types)/sizeof(types[0]); t++) {
+        benchPrecisionFilter(types[t].name, types[t].type, 1000.f, 0.707f, &x[0], n, srate, &out);
+        benchPrecisionFilter(types[t].name, types[t].type, 20.f, 10.f, &x[0], n, srate, &out);
+    }
+
+    // Sine oscillator: phase accumulated in the sample type, against the exact phase
+    const float f0 = 440.f;
+    OscGenT<float> o32(srate);
+    OscGenT<double> o64(srate);
+    o32.setWaveform(OscGen::SIN); o32.setFrequency(f0);
+    o64.setWaveform(OscGen::SIN); o64.setFrequency(f0);
+    std::vector<double> y64(n);
+    double t0 = benchNow();
+    o32.generateBlock(&out[0], n);
+    double ns32 = (benchNow() - t0)*1e9/n;
+    t0 = benchNow();
+    o64.generateBlock(&y64[0], n);
+    double ns64 = (benchNow() - t0)*1e9/n;
+    double e32 = 0, e64 = 0;
+    for (int i = n - 4096; i < n; i++) {
+        double exact = sin(fmod(2*M_PI*(double)f0/srate*i, 2*M_PI));
+        e32 = fmax(e32, fabs(out[i] - exact));
+        e64 = fmax(e64, fabs(y64[i] - exact));
+    }
+    printf("OscGen sine %.0f Hz after %d samples: float %.2f ns/sample max error %.1f dB, double %.2f ns/sample %.1f dB\n",
+            f0, n, ns32, 20*log10(e32), ns64, 20*log10(e64 + 1e-30));
+
+    // Envelope: exponential attack/decay in blocks
+    ADSRT<float> a32(srate);
+    ADSRT<double> a64(srate);
+    a32.setCurve(ADSR::EXPONENTIAL); a32.setAllTimes(0.5f, 0.5f, 0.5f, 0.5f); a32.keyOn();
+    a64.setCurve(ADSR::EXPONENTIAL); a64.setAllTimes(0.5f, 0.5f, 0.5f, 0.5f); a64.keyOn();
+    t0 = benchNow();
+    for (int i = 0; i < n; i += 256) a32.process(&out[i], (n - i < 256) ? n - i : 256);
+    ns32 = (benchNow() - t0)*1e9/n;
+    t0 = benchNow();
+    for (int i = 0; i < n; i += 256) a64.process(&y64[i], (n - i < 256) ? n - i : 256);
+    ns64 = (benchNow() - t0)*1e9/n;
+    double de = 0;
+    for (int i = 0; i < n; i++) de = fmax(de, fabs(out[i] - y64[i]));
+    printf("ADSR exponential: float %.2f ns/sample, double %.2f ns/sample, max difference %.1f dB\n",
+            ns32, ns64, 20*log10(de + 1e-30));
+}
+
+/*
+ *  Name: benchBiquadModulated(const float *x, const float *cut, float *y, int n, float srate, double *ns)
+ *  Desc: Second order lowpass (Q 5) redesigned every sample, returns the output
+ *        peak and the cost (ns may be NULL)
+ */
+static inline float benchBiquadModulated(const float *x, const float *cut, float *y, int n, float srate, double *ns) {
+    BiquadFilter bq(srate);
+    bq.setQ(5.f);
+    bq.setFilterType(BiquadFilter::SO_LPF);
+    double t0 = benchNow();
+    for (int i = 0; i < n; i++) {
+        bq.setCutoffFrequency(cut[i]);
+        bq.configureFilter();
+        y[i] = 2*bq.processBiquad(x[i]) - x[i];
+    }
+    if (ns != NULL) *ns = (benchNow() - t0)*1e9/n;
+
+    float peak = 0.f;
+    for (int i = 0; i < n; i++) peak = fmaxf(peak, fabsf(y[i]));
+    return peak;
+}
+
+/*
+ *  Name: benchSVFModulated(const float *x, const float *cut, float *y, int n, float srate, double *ns)
+ *  Desc: The same through the SVF lowpass
+ */
+static inline float benchSVFModulated(const float *x, const float *cut, float *y, int n, float srate, double *ns) {
+    SVFilter svf(srate);
+    svf.setQ(5.f);
+    double t0 = benchNow();
+    svf.processBlockModulated(x, cut, y, n);
+    if (ns != NULL) *ns = (benchNow() - t0)*1e9/n;
+
+    float peak = 0.f;
+    for (int i = 0; i < n; i++) peak = fmaxf(peak, fabsf(y[i]));
+    return peak;
+}
+
+/*
+ *  Name: benchSVF()
+ *  Desc: State-variable filter against the Butterworth biquads it matches at
+ *        a fixed cutoff, then per-sample cutoff modulation: cost (biquad
+ *        redesigned every sample, scalar SVF, four-voice SVFilterBank) and
+ *        behaviour under a fast, wide sweep
+ */
+static inline void benchSVF() {
+    const float srate = 44100.f;
+    const int n = (int)srate;
+    std::vector<float> x(n), y(n), cut(n);
+    unsigned int seed = 22222;
+    for (int i = 0; i < n; i++) {
+        seed = seed*1103515245u + 12345u;
+        x[i] = ((seed >> 8) + 0.5f)/8388608.f - 1.f;
+    }
+
+    // Fixed cutoff, Q 1/sqrt(2): both are the prewarped bilinear Butterworth.
+    // processBiquad() returns (H + 1)/2, undone here.
+    static const struct { const char *name; int mode, type; } pairs[] = {
+        { "lpf", SVFilter::LPF, BiquadFilter::SO_LPF_BUTTERS },
+        { "hpf", SVFilter::HPF, BiquadFilter::SO_HPF_BUTTERS },
+    };
+    static const float cutoffs[] = { 50.f, 1000.f, 10000.f };
+    for (int p = 0; p < 2; p++) {
+        for (int c = 0; c < 3; c++) {
+            SVFilterT<double> svf(srate);
+            svf.setMode(pairs[p].mode);
+            svf.setQ(M_SQRT1_2);
+            svf.setCutoffFrequency(cutoffs[c]);
+            BiquadFilterT<double> bq(srate);
+            bq.setCutoffFrequency(cutoffs[c]);
+            bq.setFilterType(pairs[p].type);
+
+            double diff = 0, peak = 0;
+            for (int i = 0; i < n; i++) {
+                double a = svf.process(x[i]), b = 2*bq.processBiquad(x[i]) - x[i];
+                diff = fmax(diff, fabs(a - b));
+                peak = fmax(peak, fabs(b));
+            }
+            printf("%s %5.0f Hz: SVF against Butterworth biquad, max difference %.1f dB re peak\n",
+                   pairs[p].name, cutoffs[c], 20*log10(diff/peak + 1e-30));
+        }
+    }
+
+    // Audio-rate modulation, Q 5: a 220 Hz sine with the cutoff swept 62 Hz..16 kHz
+    // by a 200 Hz sine, and a 5 kHz sine with it jumping 16 kHz <-> 60 Hz every 100 samples
+    std::vector<float> x2(n), cut2(n);
+    for (int i = 0; i < n; i++) {
+        x[i] = 0.5f*sinf(2.f*(float)M_PI*220.f*i/srate);
+        cut[i] = 1000.f*powf(2.f, 4.f*sinf(2.f*(float)M_PI*200.f*i/srate));
+        x2[i] = 0.5f*sinf(2.f*(float)M_PI*5000.f*i/srate);
+        cut2[i] = ((i/100) & 1) ? 60.f : 16000.f;
+    }
+
+    double bqNs, svfNs;
+    float bqSweep = benchBiquadModulated(&x[0], &cut[0], &y[0], n, srate, &bqNs);
+    float bqJumps = benchBiquadModulated(&x2[0], &cut2[0], &y[0], n, srate, NULL);
+    float svfJumps = benchSVFModulated(&x2[0], &cut2[0], &y[0], n, srate, NULL);
+    float svfSweep = benchSVFModulated(&x[0], &cut[0], &y[0], n, srate, &svfNs);
+
+    // The sweep on every voice of a bank, first voice checked against the scalar filter
+    const int voices = 64, block = 256;
+    SVFilterBank bank(srate, voices);
+    bank.setMode(SVFilter::LPF);
+    for (int v = 0; v < voices; v++) bank.setQ(v, 5.f);
+    std::vector<float> out((size_t)voices*n);
+    std::vector<const float *> in(voices), fc(voices);
+    std::vector<float *> dst(voices);
+    double t0 = benchNow();
+    for (int i = 0; i < n; i += block) {
+        int m = (n - i < block) ? n - i : block;
+        for (int v = 0; v < voices; v++) {
+            in[v] = &x[i];
+            fc[v] = &cut[i];
+            dst[v] = &out[(size_t)v*n + i];
+        }
+        bank.process(&in[0], &fc[0], &dst[0], m);
+    }
+    double bankNs = (benchNow() - t0)*1e9/((double)voices*n);
+    double bankDiff = 0;
+    for (int i = 0; i < n; i++) bankDiff = fmax(bankDiff, fabs(out[i] - y[i]));
+
+    printf("per-sample cutoff, Q 5, peak output (input peak 0.5):\n");
+    printf("%-30s %10s %12s %12s\n", "", "ns/sample", "sweep peak", "jumps peak");
+    printf("%-30s %10.2f %12.2f %12.2f\n", "biquad, redesigned per sample", bqNs, bqSweep, bqJumps);
+    printf("%-30s %10.2f %12.2f %12.2f\n", "SVF, processBlockModulated", svfNs, svfSweep, svfJumps);
+    printf("%-30s %10.2f   (%d voices, max difference from the scalar SVF %.2g)\n", "SVFilterBank, per voice",
+           bankNs, voices, bankDiff);
+}
+
+#endif // BENCHMARK_H
@@ -0,0 +1,512 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   CaptureStore.h
+ *
+ *   Description:   Disk-backed capture history
+ *                  Samples are appended to memory-mapped segment files together
+ *                  with a persisted multi-resolution min/max index, so any time
+ *                  range can be drawn by reading a few index pages and an old
+ *                  capture reopens without rescanning its samples
+ *
+ *                  <dir>/capture.hdr     header (sample rate, sample count)
+ *                  <dir>/seg_NNNNN.raw   SEGMENT_SIZE float samples each
+ *                  <dir>/index_N.bin     min/max pairs, BASE_BIN*BIN_FACTOR^N samples each
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef CAPTURESTORE_H
+#define CAPTURESTORE_H
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "RingBuffer.h"
+
+#define CAPTURE_MAGIC           "GLOSCCAP"      // Header magic
+
+class CaptureStore {
+public:
+    // Store Layout
+    enum {
+        NUM_LEVELS = 5,                 // index levels
+        BASE_BIN = 64,                  // samples per level 0 bin
+        BIN_FACTOR = 16,                // bins merged per level
+        SEGMENT_SIZE = 1 << 22,         // samples per segment file (16MB)
+    };
+
+    // One index entry
+    typedef struct {
+        float min;
+        float max;
+    } MinMax;
+
+    // Initializations
+    // _ringSize: samples buffered between audio and writer thread
+    // _chunkSize: samples appended per writer pass
+    CaptureStore(unsigned int _ringSize, unsigned int _chunkSize) {
+        ring = new RingBuffer<float>(_ringSize);
+        chunkSize = _chunkSize;
+        chunk = new float[chunkSize];
+        hdrFd = -1;
+        for (int l = 0; l < NUM_LEVELS; l++) idxFd[l] = -1;
+        count = 0;
+        srate = 0;
+        capturing = false;
+        running = false;
+        dropped = 0;
+    };
+    ~CaptureStore() {
+        stop();
+        close();
+        delete ring;
+        delete [] chunk;
+    };
+
+    // Opens (or creates) a capture directory, restoring the index tail
+    bool open(const char *_dir, float _srate) {
+        std::lock_guard<std::mutex> lock(mtx);
+        char path[512];
+
+        snprintf(dir, sizeof(dir), "%s", _dir);
+        mkdir(dir, 0755);
+
+        snprintf(path, sizeof(path), "%s/capture.hdr", dir);
+        hdrFd = ::open(path, O_RDWR | O_CREAT, 0644);
+        if (hdrFd < 0) {
+            printf("[capture]: could not open %s\n", path);
+            return false;
+        }
+
+        Header hdr;
+        if (pread(hdrFd, &hdr, sizeof(hdr), 0) == sizeof(hdr) && memcmp(hdr.magic, CAPTURE_MAGIC, 8) == 0
+                && hdr.segmentSize == SEGMENT_SIZE && hdr.baseBin == BASE_BIN
+                && hdr.binFactor == BIN_FACTOR && hdr.numLevels == NUM_LEVELS) {
+            count = hdr.sampleCount;
+            srate = hdr.srate;
+        }
+        else {
+            count = 0;
+            srate = _srate;
+        }
+
+        for (int l = 0; l < NUM_LEVELS; l++) {
+            snprintf(path, sizeof(path), "%s/index_%d.bin", dir, l);
+            idxFd[l] = ::open(path, O_RDWR | O_CREAT, 0644);
+            if (idxFd[l] < 0) {
+                printf("[capture]: could not open %s\n", path);
+                return false;
+            }
+        }
+
+        unsigned long long segs = (count + SEGMENT_SIZE - 1) / SEGMENT_SIZE;
+        for (unsigned long long s = 0; s < segs; s++) {
+            float *p = mapSegment(s);
+            if (p == NULL) return false;
+            segments.push_back(p);
+        }
+
+        restoreIndex();
+        writeHeader();
+        return true;
+    };
+
+    // Flushes the index and unmaps everything (not while capturing)
+    void close() {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (hdrFd < 0) return;
+
+        flushIndex();
+        writeHeader();
+        for (unsigned int s = 0; s < segments.size(); s++)
+            munmap(segments[s], sizeof(float)*SEGMENT_SIZE);
+        segments.clear();
+        for (int l = 0; l < NUM_LEVELS; l++) {
+            ::close(idxFd[l]);
+            idxFd[l] = -1;
+        }
+        ::close(hdrFd);
+        hdrFd = -1;
+    };
+
+    // Start/stop the writer thread (not from the audio thread)
+    bool start() {
+        if (running || hdrFd < 0) return false;
+        ring->flush();
+        dropped = 0;
+        running = true;
+        writer = std::thread(&CaptureStore::writerLoop, this);
+        capturing.store(true, std::memory_order_release);
+        return true;
+    };
+    void stop() {
+        if (!running) return;
+        capturing.store(false, std::memory_order_release);
+        running = false;
+        writer.join();
+    };
+
+    // Audio thread: queue one block, never blocks or allocates
+    void pushBlock(const float *buf, unsigned long frames) {
+        if (!capturing.load(std::memory_order_acquire)) return;
+        if (!ring->write(buf, frames)) dropped.fetch_add(1, std::memory_order_relaxed);
+    };
+
+    // Getters
+    bool isCapturing() { return capturing.load(std::memory_order_acquire); };
+    unsigned int getDroppedBlocks() { return dropped.load(std::memory_order_relaxed); };
+    float getSampleRate() { return srate; };
+    unsigned long long getSampleCount() {
+        std::lock_guard<std::mutex> lock(mtx);
+        return count;
+    };
+
+    // Min/max envelope of [start, end) split into columns, from the coarsest
+    // index level that still resolves one column (or raw samples when zoomed in).
+    // Only the in-memory state is copied under the lock; index pages and mapped
+    // samples are read outside it, so a query never waits on the writer's disk I/O.
+    void getMinMax(unsigned long long start, unsigned long long end, int columns,
+            float *mins, float *maxs) {
+        int level = -1;
+        unsigned long long bin = 1, firstBin = 0, lastBin = 0, onDisk = 0;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+
+            if (end > count) end = count;
+            if (start >= end || columns <= 0) {
+                for (int c = 0; c < columns; c++) mins[c] = maxs[c] = 0.f;
+                return;
+            }
+
+            double spc = (double)(end - start) / columns;
+            for (int l = 0; l < NUM_LEVELS; l++) {
+                if (binSize(l) > spc) break;
+                level = l;
+                bin = binSize(l);
+            }
+
+            firstBin = start / bin;
+            lastBin = (end - 1) / bin;
+            if (level >= 0) {
+                scratch.resize(lastBin - firstBin + 1);
+                onDisk = readMemoryBins(level, firstBin, lastBin - firstBin + 1, &scratch[0]);
+            }
+            else viewSegments.assign(segments.begin(), segments.end());
+        }
+        if (onDisk > 0) readDiskBins(level, firstBin, onDisk, &scratch[0]);
+
+        double spc = (double)(end - start) / columns;
+
+        for (int c = 0; c < columns; c++) {
+            unsigned long long s0 = start + (unsigned long long)(c*spc);
+            unsigned long long s1 = start + (unsigned long long)((c + 1)*spc);
+            if (s1 <= s0) s1 = s0 + 1;
+            if (s1 > end) s1 = end;
+
+            MinMax mm = { 0.f, 0.f };
+            if (level < 0) {
+                mm.min = mm.max = viewSegments[s0 / SEGMENT_SIZE][s0 % SEGMENT_SIZE];
+                for (unsigned long long s = s0 + 1; s < s1; s++) {
+                    float x = viewSegments[s / SEGMENT_SIZE][s % SEGMENT_SIZE];
+                    if (x < mm.min) mm.min = x;
+                    if (x > mm.max) mm.max = x;
+                }
+            }
+            else {
+                unsigned long long b0 = s0 / bin - firstBin;
+                unsigned long long b1 = (s1 - 1) / bin - firstBin;
+                mm = scratch[b0];
+                for (unsigned long long b = b0 + 1; b <= b1; b++) merge(mm, scratch[b]);
+            }
+            mins[c] = mm.min;
+            maxs[c] = mm.max;
+        }
+    };
+
+private:
+    // On-disk header
+    typedef struct {
+        char magic[8];
+        unsigned int srate;
+        unsigned int segmentSize;
+        unsigned int baseBin;
+        unsigned int binFactor;
+        unsigned int numLevels;
+        unsigned int reserved;
+        unsigned long long sampleCount;
+    } Header;
+
+    static unsigned long long binSize(int level) {
+        unsigned long long b = BASE_BIN;
+        for (int l = 0; l < level; l++) b *= BIN_FACTOR;
+        return b;
+    };
+
+    static void merge(MinMax &a, const MinMax &b) {
+        if (b.min < a.min) a.min = b.min;
+        if (b.max > a.max) a.max = b.max;
+    };
+
+    float sampleAt(unsigned long long s) {
+        return segments[s / SEGMENT_SIZE][s % SEGMENT_SIZE];
+    };
+
+    float *mapSegment(unsigned long long seg) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/seg_%05llu.raw", dir, seg);
+        int fd = ::open(path, O_RDWR | O_CREAT, 0644);
+        if (fd < 0 || ftruncate(fd, sizeof(float)*SEGMENT_SIZE) != 0) {
+            printf("[capture]: could not create %s\n", path);
+            if (fd >= 0) ::close(fd);
+            return NULL;
+        }
+        void *p = mmap(NULL, sizeof(float)*SEGMENT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            printf("[capture]: could not map %s\n", path);
+            return NULL;
+        }
+        return (float *)p;
+    };
+
+    void writeHeader() {
+        Header hdr;
+        memset(&hdr, 0, sizeof(hdr));
+        memcpy(hdr.magic, CAPTURE_MAGIC, 8);
+        hdr.srate = (unsigned int)srate;
+        hdr.segmentSize = SEGMENT_SIZE;
+        hdr.baseBin = BASE_BIN;
+        hdr.binFactor = BIN_FACTOR;
+        hdr.numLevels = NUM_LEVELS;
+        hdr.sampleCount = count;
+        if (pwrite(hdrFd, &hdr, sizeof(hdr), 0) != sizeof(hdr))
+            printf("[capture]: header write failed\n");
+    };
+
+    // Entries [first, first+n) of a level, from disk, pending memory or the open bin
+    void readBins(int level, unsigned long long first, unsigned long long n, MinMax *out) {
+        unsigned long long m = readMemoryBins(level, first, n, out);
+        if (m > 0) readDiskBins(level, first, m, out);
+    };
+
+    // The in-memory part of readBins(), returns how many leading entries are
+    // on disk instead (left for readDiskBins, which needs no lock: flushed
+    // entries are never rewritten)
+    unsigned long long readMemoryBins(int level, unsigned long long first, unsigned long long n, MinMax *out) {
+        unsigned long long i = first, e = first + n, m = 0;
+        if (i < flushed[level]) {
+            m = (e < flushed[level] ? e : flushed[level]) - i;
+            out += m;
+            i += m;
+        }
+        for (; i < e && i < entries[level]; i++) *out++ = pending[level][i - flushed[level]];
+        for (; i < e; i++) *out++ = openBin(level);
+        return m;
+    };
+
+    void readDiskBins(int level, unsigned long long first, unsigned long long m, MinMax *out) {
+        if (pread(idxFd[level], out, sizeof(MinMax)*m, sizeof(MinMax)*first) != (ssize_t)(sizeof(MinMax)*m))
+            memset(out, 0, sizeof(MinMax)*m);
+    };
+
+    // The incomplete bin at the live edge, including all finer partial bins
+    MinMax openBin(int level) {
+        MinMax mm = { 0.f, 0.f };
+        bool any = false;
+        for (int l = 0; l <= level; l++) {
+            if (accCount[l] == 0) continue;
+            if (!any) mm = acc[l];
+            else merge(mm, acc[l]);
+            any = true;
+        }
+        return mm;
+    };
+
+    // A bin at this level is complete, feed it to the next coarser level
+    void pushBin(int level, MinMax mm) {
+        pending[level].push_back(mm);
+        entries[level]++;
+        if (level + 1 >= NUM_LEVELS) return;
+
+        if (accCount[level + 1] == 0) acc[level + 1] = mm;
+        else merge(acc[level + 1], mm);
+        if (++accCount[level + 1] == BIN_FACTOR) {
+            accCount[level + 1] = 0;
+            pushBin(level + 1, acc[level + 1]);
+        }
+    };
+
+    void flushIndex() {
+        writeIndex();
+        commitIndex();
+    };
+
+    // Pending bins to disk. Only the writer thread changes the index, so this
+    // runs without the lock while queries keep reading pending from memory.
+    void writeIndex() {
+        for (int l = 0; l < NUM_LEVELS; l++) {
+            if (pending[l].empty()) continue;
+            size_t bytes = sizeof(MinMax)*pending[l].size();
+            if (pwrite(idxFd[l], &pending[l][0], bytes, sizeof(MinMax)*flushed[l]) != (ssize_t)bytes)
+                printf("[capture]: index write failed\n");
+        }
+    };
+
+    // Written bins are read from disk from now on (under the lock)
+    void commitIndex() {
+        for (int l = 0; l < NUM_LEVELS; l++) {
+            flushed[l] = entries[l];
+            pending[l].clear();
+        }
+    };
+
+    // Appends samples in bin-aligned runs so min/max is a tight reduction loop
+    void append(const float *buf, unsigned int n) {
+        while (n > 0) {
+            unsigned long long seg = count / SEGMENT_SIZE;
+            unsigned int off = count % SEGMENT_SIZE;
+            if (seg >= segments.size()) {
+                float *p = mapSegment(seg);
+                if (p == NULL) return;
+                segments.push_back(p);
+            }
+
+            unsigned int run = BASE_BIN - accCount[0];
+            if (run > n) run = n;
+            if (run > SEGMENT_SIZE - off) run = SEGMENT_SIZE - off;
+
+            memcpy(segments[seg] + off, buf, sizeof(float)*run);
+
+            float lo = buf[0], hi = buf[0];
+            for (unsigned int i = 1; i < run; i++) {
+                lo = buf[i] < lo ? buf[i] : lo;
+                hi = buf[i] > hi ? buf[i] : hi;
+            }
+            MinMax mm = { lo, hi };
+            if (accCount[0] == 0) acc[0] = mm;
+            else merge(acc[0], mm);
+            accCount[0] += run;
+            if (accCount[0] == BASE_BIN) {
+                accCount[0] = 0;
+                pushBin(0, acc[0]);
+            }
+
+            count += run;
+            buf += run;
+            n -= run;
+        }
+    };
+
+    // Rebuilds missing index entries and the open bins after reopening
+    void restoreIndex() {
+        for (int l = 0; l < NUM_LEVELS; l++) {
+            unsigned long long expected = count / binSize(l);
+            struct stat st;
+            fstat(idxFd[l], &st);
+            unsigned long long onDisk = st.st_size / sizeof(MinMax);
+            if (onDisk > expected) {
+                // entries flushed after the last header update
+                if (ftruncate(idxFd[l], sizeof(MinMax)*expected) != 0)
+                    printf("[capture]: could not truncate index %d\n", l);
+                onDisk = expected;
+            }
+            flushed[l] = entries[l] = onDisk;
+            pending[l].clear();
+            accCount[l] = 0;
+        }
+
+        // level 0 from raw samples, coarser levels from the level below
+        for (int l = 0; l < NUM_LEVELS; l++) {
+            unsigned long long units = (l == 0) ? count : entries[l - 1];
+            unsigned int per = (l == 0) ? BASE_BIN : BIN_FACTOR;
+            unsigned long long u = entries[l]*per;
+
+            while (u < units) {
+                MinMax mm;
+                if (l == 0) { mm.min = mm.max = sampleAt(u); }
+                else readBins(l - 1, u, 1, &mm);
+
+                if (accCount[l] == 0) acc[l] = mm;
+                else merge(acc[l], mm);
+                u++;
+                if (++accCount[l] == per) {
+                    accCount[l] = 0;
+                    pending[l].push_back(acc[l]);
+                    entries[l]++;
+                }
+            }
+        }
+        flushIndex();
+    };
+
+    // Writer thread: appends whole chunks and keeps the header current. The
+    // lock covers the in-memory updates only, the file writes happen outside it.
+    void writerLoop() {
+        while (running || ring->readAvailable() > 0) {
+            if (running && ring->readAvailable() < chunkSize) {
+                usleep(10000);
+                continue;
+            }
+            unsigned int n = ring->read(chunk, chunkSize);
+
+            // A chunk starts at most one new segment, created before locking
+            float *next = NULL;
+            if (n > 0 && (count + n - 1) / SEGMENT_SIZE >= segments.size()) next = mapSegment(segments.size());
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                if (next != NULL) segments.push_back(next);
+                append(chunk, n);
+            }
+            writeIndex();
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                commitIndex();
+            }
+            writeHeader();
+        }
+    };
+
+    RingBuffer<float> *ring;
+    float *chunk;
+    unsigned int chunkSize;
+
+    char dir[256];
+    int hdrFd;
+    float srate;
+    unsigned long long count;
+    std::vector<float *> segments;
+
+    // Index State
+    int idxFd[NUM_LEVELS];
+    unsigned long long entries[NUM_LEVELS];     // complete bins per level
+    unsigned long long flushed[NUM_LEVELS];     // complete bins already on disk
+    std::vector<MinMax> pending[NUM_LEVELS];    // complete bins not yet on disk
+    MinMax acc[NUM_LEVELS];                     // open bin per level
+    unsigned int accCount[NUM_LEVELS];          // units in the open bin
+    std::vector<MinMax> scratch;                // query scratch (display thread only)
+    std::vector<float *> viewSegments;          // segments seen by the last query
+
+    // Threads Management
+    std::mutex mtx;
+    std::thread writer;
+    std::atomic<bool> capturing;
+    std::atomic<bool> running;
+    std::atomic<unsigned int> dropped;
+};
+
+#endif // CAPTURESTORE_H
@@ -0,0 +1,125 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   ControlQueue.h
+ *
+ *   Description:   Sample-accurate control events
+ *                  The GUI thread stamps each event with a sample time one block
+ *                  ahead of the audio clock and pushes it into a lock-free queue,
+ *                  the audio thread splits its block at each event's offset
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef CONTROLQUEUE_H
+#define CONTROLQUEUE_H
+
+#include <atomic>
+#include <chrono>
+
+#include "RingBuffer.h"
+
+// One timestamped control change
+typedef struct {
+    unsigned long long time;    // Sample time at the internal rate
+    int type;                   // ControlQueue::TYPE
+    int param;                  // Unused by the note events (0), kept for the session file layout
+    float value;                // Frequency for NOTE_ON
+} ControlEvent;
+
+class ControlQueue {
+public:
+    // Event Type
+    enum TYPE {
+        NOTE_ON = 0,
+        NOTE_OFF = 1,
+    };
+
+    // Initializations
+    ControlQueue(unsigned int _capacity, float _srate) {
+        queue = new RingBuffer<ControlEvent>(_capacity);
+        srate = _srate;
+        seq = 0;
+        clockTime = 0;
+        clockWall = 0;
+        clockFrames = 0;
+    };
+    ~ControlQueue() { delete queue; };
+
+    /*
+     *  Name: scheduleTime()
+     *  Desc: GUI thread: sample time for an event raised now. One block of
+     *        constant latency keeps the spacing between events exact.
+     */
+    unsigned long long scheduleTime() {
+        unsigned long long t0, frames;
+        double w0;
+        unsigned int s;
+        do {
+            s = seq.load(std::memory_order_acquire);
+            t0 = clockTime.load(std::memory_order_relaxed);
+            w0 = clockWall.load(std::memory_order_relaxed);
+            frames = clockFrames.load(std::memory_order_relaxed);
+        } while ((s & 1) || s != seq.load(std::memory_order_acquire));
+
+        double elapsed = (wallNow() - w0) * srate;
+        if (elapsed < 0) elapsed = 0;
+        if (elapsed > frames) elapsed = frames;
+        return t0 + frames + (unsigned long long)elapsed;
+    };
+
+    // GUI thread: stamp and queue an event, false if the queue is full
+    bool push(int type, int param, float value) {
+        return pushAt(scheduleTime(), type, param, value);
+    };
+    bool pushAt(unsigned long long time, int type, int param, float value) {
+        ControlEvent ev = { time, type, param, value };
+        return queue->write(&ev, 1);
+    };
+
+    // Audio thread: pops the next event if it is due before sample time 'before'
+    bool pop(ControlEvent *ev, unsigned long long before) {
+        if (!queue->peek(ev) || ev->time >= before) return false;
+        queue->read(ev, 1);
+        return true;
+    };
+
+    // Audio thread: time of the next queued event
+    bool peekTime(unsigned long long *time) {
+        ControlEvent ev;
+        if (!queue->peek(&ev)) return false;
+        *time = ev.time;
+        return true;
+    };
+
+    // Audio thread: publish the clock after rendering [time - frames, time)
+    void publishClock(unsigned long long time, unsigned long frames) {
+        seq.fetch_add(1, std::memory_order_acq_rel);
+        clockTime.store(time, std::memory_order_relaxed);
+        clockWall.store(wallNow(), std::memory_order_relaxed);
+        clockFrames.store(frames, std::memory_order_relaxed);
+        seq.fetch_add(1, std::memory_order_release);
+    };
+
+private:
+    static double wallNow() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    };
+
+    RingBuffer<ControlEvent> *queue;
+    float srate;
+
+    // Audio clock, seqlock so the GUI never sees a torn update
+    std::atomic<unsigned int> seq;
+    std::atomic<unsigned long long> clockTime;
+    std::atomic<double> clockWall;
+    std::atomic<unsigned long long> clockFrames;
+};
+
+#endif // CONTROLQUEUE_H
@@ -0,0 +1,87 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   DSPModule.h
+ *
+ *   Description:   Host side of DSPPlugin.h
+ *                  One instance of a module, from a shared object (dlopen) or a
+ *                  table compiled into the app
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef DSPMODULE_H
+#define DSPMODULE_H
+
+#include <stdio.h>
+#include <dlfcn.h>
+
+#include "DSPPlugin.h"
+
+class DSPModule {
+public:
+    // Initializations (handle is closed with the module, NULL for built-in tables)
+    DSPModule(const DSPPlugin *_desc, void *_handle, float srate, int maxBlock) {
+        desc = _desc;
+        handle = _handle;
+        self = desc->create(srate, maxBlock);
+    };
+    ~DSPModule() {
+        if (self != NULL) desc->destroy(self);
+        if (handle != NULL) dlclose(handle);
+    };
+
+    /*
+     *  Name: open(const char *path, float srate, int maxBlock)
+     *  Desc: Loads a module from a shared object, NULL (with the reason printed)
+     *        if it can't be loaded, has no entry point or another ABI
+     */
+    static DSPModule *open(const char *path, float srate, int maxBlock) {
+        void *handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+        if (handle == NULL) {
+            printf("[plugin]: %s\n", dlerror());
+            return NULL;
+        }
+
+        DSPPluginEntry entry = (DSPPluginEntry)dlsym(handle, DSP_PLUGIN_ENTRY);
+        const DSPPlugin *desc = (entry != NULL) ? entry() : NULL;
+        if (desc == NULL) {
+            printf("[plugin]: %s has no %s() entry point\n", path, DSP_PLUGIN_ENTRY);
+            dlclose(handle);
+            return NULL;
+        }
+        if (desc->abi != DSP_PLUGIN_ABI) {
+            printf("[plugin]: %s built for ABI %d, host is %d\n", path, desc->abi, DSP_PLUGIN_ABI);
+            dlclose(handle);
+            return NULL;
+        }
+
+        DSPModule *m = new DSPModule(desc, handle, srate, maxBlock);
+        if (m->self == NULL) {
+            printf("[plugin]: %s failed to create an instance\n", path);
+            delete m;
+            return NULL;
+        }
+        return m;
+    };
+
+    // Getters
+    const char *getName() { return desc->name; };
+
+    void reset() { desc->reset(self); };
+    void setParam(int id, float value) { desc->setParam(self, id, value); };
+    void process(const float *in, float *out, int n) { desc->process(self, in, out, n); };
+
+private:
+    const DSPPlugin *desc;
+    void *handle;
+    void *self;
+};
+
+#endif // DSPMODULE_H
@@ -0,0 +1,57 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   DSPPlugin.h
+ *
+ *   Description:   C ABI for DSP modules loaded from shared objects
+ *                  A module exports DSP_PLUGIN_ENTRY, which returns a table of
+ *                  plain C functions. The host creates instances off the audio
+ *                  thread; process() runs on it and must not allocate or block.
+ *                  Plain C, so modules can be built from C or C++:
+ *                      g++ -shared -fPIC -o module.so module.cpp
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef DSPPLUGIN_H
+#define DSPPLUGIN_H
+
+#define DSP_PLUGIN_ABI          1               // Bumped on any change to DSPPlugin
+#define DSP_PLUGIN_ENTRY        "dsp_plugin"    // Exported symbol, a DSPPluginEntry
+
+#ifdef __cplusplus
+#define DSP_PLUGIN_EXPORT       extern "C" __attribute__((visibility("default")))
+#else
+#define DSP_PLUGIN_EXPORT       __attribute__((visibility("default")))
+#endif
+
+// Parameters the host sets on both sides of a comparison (modules ignore the rest)
+enum DSP_PARAM {
+    DSP_PARAM_FREQUENCY = 0,    // Oscillator frequency (Hz)
+    DSP_PARAM_CUTOFF = 1,       // Filter cutoff (Hz)
+    DSP_PARAM_Q = 2,            // Filter Q
+    DSP_PARAM_TYPE = 3,         // BiquadFilter::FILTER (filters) or OscGen::WAVEFORM
+};
+
+typedef struct DSPPlugin {
+    int abi;                    // DSP_PLUGIN_ABI the module was built against
+    const char *name;
+
+    void *(*create)(float srate, int maxBlock);
+    void (*destroy)(void *self);
+    void (*reset)(void *self);
+    void (*setParam)(void *self, int id, float value);
+
+    // n <= maxBlock samples; in and out may be the same buffer
+    void (*process)(void *self, const float *in, float *out, int n);
+} DSPPlugin;
+
+typedef const DSPPlugin *(*DSPPluginEntry)(void);
+
+#endif // DSPPLUGIN_H
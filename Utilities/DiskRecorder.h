@@ -0,0 +1,187 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   DiskRecorder.h
+ *
+ *   Description:   Non-blocking disk recorder
+ *                  The audio thread only pushes blocks into a preallocated ring,
+ *                  a writer thread batches them to libsndfile with large writes
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef DISKRECORDER_H
+#define DISKRECORDER_H
+
+#include <stdio.h>
+#include <unistd.h>
+#include <sndfile.h>
+#include <atomic>
+#include <thread>
+
+#include "RingBuffer.h"
+#include "Resampler.h"
+
+class DiskRecorder {
+public:
+    // Point in the chain being recorded
+    enum TAP {
+        TAP_INPUT = 0,      // Raw mic input
+        TAP_SYNTH = 1,      // Oscillator output
+        TAP_FILTER = 2,     // Filter output
+        TAP_OUTPUT = 3,     // Post-volume output
+        NUM_TAPS = 4,
+    };
+
+    // Initializations
+    // _ringSize: samples of headroom between audio and writer thread
+    // _chunkSize: samples per libsndfile write
+    DiskRecorder(unsigned int _ringSize, unsigned int _chunkSize) {
+        ring = new RingBuffer<float>(_ringSize);
+        chunkSize = _chunkSize;
+        chunk = new float[chunkSize];
+        file = NULL;
+        rs = NULL;
+        rsOut = NULL;
+        tap = TAP_OUTPUT;
+        recording = false;
+        pushing = false;
+        running = false;
+        highWater = 0;
+        dropped = 0;
+        written = 0;
+    };
+    ~DiskRecorder() {
+        stop();
+        delete ring;
+        delete [] chunk;
+        delete rs;
+        delete [] rsOut;
+    };
+
+    // Setters (any thread, the audio thread picks it up at its next block)
+    void setTap(int _tap) { tap.store(_tap, std::memory_order_relaxed); };
+
+    // Converts to the file's rate on the writer thread (not while recording)
+    void setFileRate(float srate, float fileRate) {
+        delete rs;
+        delete [] rsOut;
+        rs = NULL;
+        rsOut = NULL;
+        if (srate == fileRate) return;
+
+        rs = new Resampler(srate, fileRate, 64, 256, chunkSize);
+        rsOutSize = rs->outputAvailable(chunkSize) + 1;
+        rsOut = new float[rsOutSize];
+    };
+
+    // Getters
+    int getTap() { return tap.load(std::memory_order_relaxed); };
+    bool isRecording() { return recording.load(std::memory_order_acquire); };
+    unsigned int getRingSize() { return ring->capacity(); };
+    unsigned int getHighWaterMark() { return highWater.load(std::memory_order_relaxed); };
+    unsigned int getDroppedBlocks() { return dropped.load(std::memory_order_relaxed); };
+    sf_count_t getFramesWritten() { return written; };
+
+    // Start recording into an already opened file (not from the audio thread)
+    bool start(SNDFILE *_file) {
+        if (running || _file == NULL) return false;
+        file = _file;
+        ring->flush();
+        if (rs) rs->reset();
+        highWater = 0;
+        dropped = 0;
+        written = 0;
+        running = true;
+        writer = std::thread(&DiskRecorder::writerLoop, this);
+        recording.store(true, std::memory_order_release);
+        return true;
+    };
+
+    // Stop recording, drain the ring and join the writer (not from the audio thread).
+    // A pushBlock() that started before the flag cleared is waited for, so its
+    // block still reaches the file and nothing touches the ring afterwards.
+    void stop() {
+        if (!running) return;
+        recording.store(false);
+        while (pushing.load()) usleep(100);
+        running = false;
+        writer.join();
+        file = NULL;
+    };
+
+    // Audio thread: queue one block, never blocks or allocates
+    void pushBlock(const float *buf, unsigned long frames) {
+        // Seen by stop() (sequentially consistent with its clearing of recording)
+        pushing.store(true);
+        if (!recording.load()) {
+            pushing.store(false, std::memory_order_release);
+            return;
+        }
+
+        if (!ring->write(buf, frames)) dropped.fetch_add(1, std::memory_order_relaxed);
+        else {
+            unsigned int used = ring->readAvailable();
+            if (used > highWater.load(std::memory_order_relaxed))
+                highWater.store(used, std::memory_order_relaxed);
+        }
+        pushing.store(false, std::memory_order_release);
+    };
+
+private:
+    // Writer thread: waits for a full chunk before touching the disk
+    void writerLoop() {
+        while (running) {
+            if (ring->readAvailable() < chunkSize) {
+                usleep(10000);
+                continue;
+            }
+            flushChunk();
+        }
+        // drain whatever is left
+        while (ring->readAvailable() > 0) flushChunk();
+    };
+
+    void flushChunk() {
+        unsigned int n = ring->read(chunk, chunkSize);
+        if (n == 0) return;
+
+        float *out = chunk;
+        if (rs) {
+            int used;
+            unsigned int in = n;
+            n = rs->process(chunk, n, rsOut, rsOutSize, &used);
+            if (used < (int)in) dropped.fetch_add(1, std::memory_order_relaxed);
+            out = rsOut;
+        }
+        if (sf_write_float(file, out, n) != n)
+            printf("[recorder]: write error: %s\n", sf_strerror(file));
+        written += n;
+    };
+
+    RingBuffer<float> *ring;
+    float *chunk;
+    unsigned int chunkSize;
+    Resampler *rs;          // Internal -> file rate, NULL when equal
+    float *rsOut;
+    int rsOutSize;
+    SNDFILE *file;
+    sf_count_t written;
+    std::atomic<int> tap;   // Set by the UI, read by the audio thread
+
+    // Threads Management
+    std::thread writer;
+    std::atomic<bool> recording;
+    std::atomic<bool> pushing;      // Audio thread inside pushBlock()
+    std::atomic<bool> running;
+    std::atomic<unsigned int> highWater;
+    std::atomic<unsigned int> dropped;
+};
+
+#endif // DISKRECORDER_H
@@ -0,0 +1,145 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   FFT.h
+ *
+ *   Description:   Radix-2 FFT for power-of-two sizes
+ *                  Iterative in-place complex transform on split re/im arrays,
+ *                  and a real transform that packs N real samples into an N/2
+ *                  complex transform and untangles the halves afterwards
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef FFT_H
+#define FFT_H
+
+#include <math.h>
+#include <vector>
+
+class FFT {
+public:
+    // Initializations (n is the real transform size, a power of two >= 4)
+    FFT(int _n) {
+        n = _n;
+        half = n/2;
+
+        // Bit reversal for the half-size complex transform
+        int bits = 0;
+        while ((1 << bits) < half) bits++;
+        rev.resize(half);
+        for (int i = 0; i < half; i++) {
+            int r = 0;
+            for (int b = 0; b < bits; b++) r |= ((i >> b) & 1) << (bits - 1 - b);
+            rev[i] = r;
+        }
+
+        // Twiddles: half-size butterflies, and e^-j2pik/n to split the real spectrum
+        cosH.resize(half/2 > 0 ? half/2 : 1); sinH.resize(cosH.size());
+        for (int k = 0; k < half/2; k++) {
+            cosH[k] = cos(2*M_PI*k/half);
+            sinH[k] = -sin(2*M_PI*k/half);
+        }
+        cosN.resize(half + 1); sinN.resize(half + 1);
+        for (int k = 0; k <= half; k++) {
+            cosN[k] = cos(2*M_PI*k/n);
+            sinN[k] = -sin(2*M_PI*k/n);
+        }
+
+        zr.resize(half); zi.resize(half);
+    };
+    ~FFT() {};
+
+    // Getters
+    int getSize() { return n; };
+
+    /*
+     *  Name: complexForward(float *re, float *im)
+     *  Desc: In-place forward transform of n/2 complex points
+     */
+    void complexForward(float *re, float *im) {
+        for (int i = 0; i < half; i++) {
+            int j = rev[i];
+            if (j > i) {
+                float t = re[i]; re[i] = re[j]; re[j] = t;
+                t = im[i]; im[i] = im[j]; im[j] = t;
+            }
+        }
+
+        for (int size = 2; size <= half; size <<= 1) {
+            int h = size >> 1, step = half/size;
+            for (int start = 0; start < half; start += size) {
+                for (int k = 0; k < h; k++) {
+                    float wr = cosH[k*step], wi = sinH[k*step];
+                    int a = start + k, b = a + h;
+                    float tr = re[b]*wr - im[b]*wi;
+                    float ti = re[b]*wi + im[b]*wr;
+                    re[b] = re[a] - tr; im[b] = im[a] - ti;
+                    re[a] += tr; im[a] += ti;
+                }
+            }
+        }
+    };
+
+    /*
+     *  Name: realForward(const float *x, float *re, float *im)
+     *  Desc: Spectrum of n real samples, bins 0..n/2 (re and im hold n/2 + 1)
+     */
+    void realForward(const float *x, float *re, float *im) {
+        // Even samples as real part, odd as imaginary
+        for (int k = 0; k < half; k++) {
+            zr[k] = x[2*k];
+            zi[k] = x[2*k + 1];
+        }
+        complexForward(&zr[0], &zi[0]);
+
+        // X[k] = E[k] + W^k O[k], with E and O recovered from Z[k] and conj(Z[half - k])
+        for (int k = 0; k <= half; k++) {
+            int a = (k == half) ? 0 : k, b = (k == 0) ? 0 : half - k;
+            float er = 0.5f*(zr[a] + zr[b]), ei = 0.5f*(zi[a] - zi[b]);
+            float orr = 0.5f*(zi[a] + zi[b]), oi = -0.5f*(zr[a] - zr[b]);
+            re[k] = er + cosN[k]*orr - sinN[k]*oi;
+            im[k] = ei + cosN[k]*oi + sinN[k]*orr;
+        }
+    };
+
+    /*
+     *  Name: realInverse(const float *re, const float *im, float *x)
+     *  Desc: n real samples from bins 0..n/2, scaled so realInverse(realForward(x)) = x
+     */
+    void realInverse(const float *re, const float *im, float *x) {
+        // E[k] and O[k] back from X[k] and conj(X[half - k]), packed as Z = E + jO
+        for (int k = 0; k < half; k++) {
+            int b = half - k;
+            float er = 0.5f*(re[k] + re[b]), ei = 0.5f*(im[k] - im[b]);
+            float dr = 0.5f*(re[k] - re[b]), di = 0.5f*(im[k] + im[b]);
+            float orr = dr*cosN[k] + di*sinN[k], oi = di*cosN[k] - dr*sinN[k];
+            zr[k] = er - oi;
+            zi[k] = ei + orr;
+        }
+
+        // Inverse as a forward transform with re and im swapped on the way in and out
+        complexForward(&zi[0], &zr[0]);
+
+        float scale = 1.f/half;
+        for (int k = 0; k < half; k++) {
+            x[2*k] = zr[k]*scale;
+            x[2*k + 1] = zi[k]*scale;
+        }
+    };
+
+private:
+    int n, half;
+    std::vector<int> rev;
+    std::vector<float> cosH, sinH;      // half-size butterflies
+    std::vector<float> cosN, sinN;      // real spectrum split
+    std::vector<float> zr, zi;          // packed scratch
+};
+
+#endif // FFT_H
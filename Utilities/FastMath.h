@@ -0,0 +1,281 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   FastMath.h
+ *
+ *   Description:   Vectorized approximations of sin/cos, tan, exp2/log2, tanh, pow
+ *                  Four lanes per v4 call; the scalar forms are separate
+ *                  functions running the same polynomials on one float with
+ *                  their own range reduction, not lane 0 of a vector call.
+ *                  The level template argument picks the polynomial degree,
+ *                  max relative error over every function:
+ *                      FM_FAST     1e-3
+ *                      FM_NORMAL   2e-5
+ *                      FM_PRECISE  2e-6, a few ulp (tanh and pow: ~20 ulp)
+ *                  Coefficients are minimax fits on the reduced ranges.
+ *                  Inputs: |x| < 2^22 for the trig functions, x > 0 (normal) for
+ *                  log2/pow. ./main --bench fastmath reports error and speed,
+ *                  and fails if a level exceeds its bound.
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef FASTMATH_H
+#define FASTMATH_H
+
+#include <math.h>
+#include <string.h>
+
+#include "SIMD.h"
+
+// Accuracy levels
+enum FM_ACCURACY {
+    FM_FAST = 0,
+    FM_NORMAL = 1,
+    FM_PRECISE = 2,
+};
+
+// Max relative error of each level (results above 1e-3 in magnitude)
+#define FM_FAST_MAX_REL         1e-3
+#define FM_NORMAL_MAX_REL       2e-5
+#define FM_PRECISE_MAX_REL      2e-6
+
+// Level used when none is given (-DFASTMATH_DEFAULT=FM_FAST for the cheapest)
+#ifndef FASTMATH_DEFAULT
+#define FASTMATH_DEFAULT        FM_NORMAL
+#endif
+
+// pi/2 in three parts (Cody-Waite), so reduction stays exact for large arguments
+#define FM_PIO2_HI              1.5703125f
+#define FM_PIO2_MID             4.837512969970703125e-4f
+#define FM_PIO2_LO              7.54978995489188216e-8f
+#define FM_2_PI                 0.636619772367581343f
+#define FM_LOG2E                1.44269504088896341f
+#define FM_SQRT2                1.41421356237309505f
+
+// Adding 1.5*2^23 rounds to the nearest integer, which then sits in the low mantissa
+// bits: no float/int conversions (needs strict float semantics, not -ffast-math)
+#define FM_ROUND_MAGIC          12582912.f
+#define FM_ROUND_BITS           0x4b400000
+
+// Lane helpers: round to nearest (as float, and as int in *n), select by mask
+static inline v4sf fmRound(v4sf x, v4si *n) {
+    v4sf t = x + FM_ROUND_MAGIC;
+    *n = (v4si)t - FM_ROUND_BITS;
+    return t - FM_ROUND_MAGIC;
+}
+static inline v4sf fmSelect(v4si mask, v4sf a, v4sf b) {
+    return (v4sf)(((v4si)a & mask) | ((v4si)b & ~mask));
+}
+
+// Polynomials, shared by the four-lane kernels (T = v4sf) and the scalar forms (T = float)
+
+/*
+ *  Name: fmSinCosPoly(T r, T *s, T *c)
+ *  Desc: sin and cos of r in [-pi/4, pi/4]
+ */
+template <int L, typename T>
+static inline void fmSinCosPoly(T r, T *s, T *c) {
+    T z = r*r;
+    if (L == FM_FAST) {
+        *s = r + r*z*-1.624279153e-1f;
+        *c = 1.f - 0.5f*z + z*z*4.089930536e-2f;
+    }
+    else if (L == FM_NORMAL) {
+        *s = r + r*z*(-1.666339038e-1f + z*8.163281924e-3f);
+        *c = 1.f - 0.5f*z + z*z*(4.166107131e-2f + z*-1.364871436e-3f);
+    }
+    else {
+        *s = r + r*z*(-1.666665461e-1f + z*(8.332160762e-3f + z*-1.951528321e-4f));
+        *c = 1.f - 0.5f*z + z*z*(4.166664568e-2f + z*(-1.388731625e-3f + z*2.443315704e-5f));
+    }
+}
+
+// 2^f for f in [-0.5, 0.5]
+template <int L, typename T>
+static inline T fmExp2Poly(T f) {
+    if (L == FM_FAST)
+        return 1.f + f*(6.932829272e-1f + f*(2.422109595e-1f + f*5.500893049e-2f));
+    else if (L == FM_NORMAL)
+        return 1.f + f*(6.931241934e-1f + f*(2.402409861e-1f + f*(5.590642468e-2f + f*9.582853038e-3f)));
+    else
+        return 1.f + f*(6.931469776e-1f + f*(2.402224209e-1f + f*(5.550733743e-2f
+             + f*(9.671512645e-3f + f*1.326472712e-3f))));
+}
+
+// log2(m) for m in [sqrt(1/2), sqrt(2)), as t L(t^2) with t = (m - 1)/(m + 1)
+template <int L, typename T>
+static inline T fmLog2Poly(T m) {
+    T t = (m - 1.f)/(m + 1.f), z = t*t;
+    if (L == FM_FAST)
+        return t*(2.885325895f + z*9.791267576e-1f);
+    else if (L == FM_NORMAL)
+        return t*(2.885390424f + z*(9.615883486e-1f + z*5.957801071e-1f));
+    else
+        return t*(2.885390080f + z*(9.617988474e-1f + z*(5.767144023e-1f + z*4.317355238e-1f)));
+}
+
+/*
+ *  Name: v4sincos(v4sf x, v4sf *s, v4sf *c)
+ *  Desc: Reduces to the nearest quadrant, then swaps/negates the polynomials
+ */
+template <int L = FASTMATH_DEFAULT>
+static inline void v4sincos(v4sf x, v4sf *s, v4sf *c) {
+    v4si q;
+    v4sf qf = fmRound(x*FM_2_PI, &q);
+    v4sf r = ((x - qf*FM_PIO2_HI) - qf*FM_PIO2_MID) - qf*FM_PIO2_LO;
+
+    v4sf ps, pc;
+    fmSinCosPoly<L>(r, &ps, &pc);
+
+    // Odd quadrants swap sin and cos; bit 1 of q (of q + 1 for cos) is the sign
+    v4si odd = -(q & 1);
+    v4si signS = (q & 2) << 30, signC = ((q + 1) & 2) << 30;
+    *s = (v4sf)((v4si)fmSelect(odd, pc, ps) ^ signS);
+    *c = (v4sf)((v4si)fmSelect(odd, ps, pc) ^ signC);
+}
+
+template <int L = FASTMATH_DEFAULT>
+static inline v4sf v4sin(v4sf x) { v4sf s, c; v4sincos<L>(x, &s, &c); return s; }
+
+template <int L = FASTMATH_DEFAULT>
+static inline v4sf v4cos(v4sf x) { v4sf s, c; v4sincos<L>(x, &s, &c); return c; }
+
+// tan: sin/cos of the reduced argument, -cos/sin in odd quadrants
+template <int L = FASTMATH_DEFAULT>
+static inline v4sf v4tan(v4sf x) {
+    v4si q;
+    v4sf qf = fmRound(x*FM_2_PI, &q);
+    v4sf r = ((x - qf*FM_PIO2_HI) - qf*FM_PIO2_MID) - qf*FM_PIO2_LO;
+
+    v4sf ps, pc;
+    fmSinCosPoly<L>(r, &ps, &pc);
+    return fmSelect(-(q & 1), -pc/ps, ps/pc);
+}
+
+/*
+ *  Name: v4exp2(v4sf x)
+ *  Desc: 2^x as 2^round(x) (exponent bits) times a polynomial on [-0.5, 0.5]
+ */
+template <int L = FASTMATH_DEFAULT>
+static inline v4sf v4exp2(v4sf x) {
+    v4sf lo = v4set1(-126.f), hi = v4set1(127.f);
+    x = fmSelect((v4si)(x < lo), lo, fmSelect((v4si)(x > hi), hi, x));
+
+    v4si n;
+    v4sf f = x - fmRound(x, &n);
+    return fmExp2Poly<L>(f)*(v4sf)((n + 127) << 23);
+}
+
+/*
+ *  Name: v4log2(v4sf x)
+ *  Desc: Exponent plus log2 of the mantissa, moved into [sqrt(1/2), sqrt(2))
+ */
+template <int L = FASTMATH_DEFAULT>
+static inline v4sf v4log2(v4sf x) {
+    v4si bits = (v4si)x;
+    v4si e = ((bits >> 23) & 0xff) - 127;
+    v4sf m = (v4sf)((bits & 0x7fffff) | 0x3f800000);
+
+    v4si big = (v4si)(m > FM_SQRT2);
+    m = fmSelect(big, m*0.5f, m);
+    e -= big;
+    return __builtin_convertvector(e, v4sf) + fmLog2Poly<L>(m);
+}
+
+// x^y = 2^(y log2 x), x > 0
+template <int L = FASTMATH_DEFAULT>
+static inline v4sf v4pow(v4sf x, v4sf y) { return v4exp2<L>(y*v4log2<L>(x)); }
+
+// tanh(|x|) = 1 - 2/(e^2|x| + 1), odd series below 0.1, sign put back
+template <int L = FASTMATH_DEFAULT>
+static inline v4sf v4tanh(v4sf x) {
+    v4si sign = (v4si)x & (int)0x80000000;
+    v4sf a = (v4sf)((v4si)x ^ sign);
+    a = fmSelect((v4si)(a > 9.f), v4set1(9.f), a);
+    v4sf z = a*a, series = a - a*z*(1.f/3.f - z*(2.f/15.f));
+    v4sf t = fmSelect((v4si)(a < 0.1f), series, 1.f - 2.f/(v4exp2<L>(a*(2.f*FM_LOG2E)) + 1.f));
+    return (v4sf)((v4si)t | sign);
+}
+
+// Scalar forms: the same polynomials without the round trip through a vector
+// register, which costs more than the libm call they replace
+static inline float fmBits(int i) { float f; memcpy(&f, &i, sizeof(f)); return f; }
+static inline int fmBits(float f) { int i; memcpy(&i, &f, sizeof(i)); return i; }
+static inline float fmRound(float x, int *n) {
+    float t = x + FM_ROUND_MAGIC;
+    *n = fmBits(t) - FM_ROUND_BITS;
+    return t - FM_ROUND_MAGIC;
+}
+
+template <int L = FASTMATH_DEFAULT>
+static inline void fastSinCos(float x, float *s, float *c) {
+    int q;
+    float qf = fmRound(x*FM_2_PI, &q);
+    float r = ((x - qf*FM_PIO2_HI) - qf*FM_PIO2_MID) - qf*FM_PIO2_LO, ps, pc;
+    fmSinCosPoly<L>(r, &ps, &pc);
+    *s = fmBits(fmBits((q & 1) ? pc : ps) ^ ((q & 2) << 30));
+    *c = fmBits(fmBits((q & 1) ? ps : pc) ^ (((q + 1) & 2) << 30));
+}
+
+template <int L = FASTMATH_DEFAULT> static inline float fastSin(float x) { float s, c; fastSinCos<L>(x, &s, &c); return s; }
+template <int L = FASTMATH_DEFAULT> static inline float fastCos(float x) { float s, c; fastSinCos<L>(x, &s, &c); return c; }
+
+template <int L = FASTMATH_DEFAULT>
+static inline float fastTan(float x) {
+    int q;
+    float qf = fmRound(x*FM_2_PI, &q);
+    float r = ((x - qf*FM_PIO2_HI) - qf*FM_PIO2_MID) - qf*FM_PIO2_LO, ps, pc;
+    fmSinCosPoly<L>(r, &ps, &pc);
+    return (q & 1) ? -pc/ps : ps/pc;
+}
+
+template <int L = FASTMATH_DEFAULT>
+static inline float fastExp2(float x) {
+    x = (x < -126.f) ? -126.f : ((x > 127.f) ? 127.f : x);
+    int n;
+    float f = x - fmRound(x, &n);
+    return fmExp2Poly<L>(f)*fmBits((n + 127) << 23);
+}
+
+template <int L = FASTMATH_DEFAULT>
+static inline float fastLog2(float x) {
+    int bits = fmBits(x), e = ((bits >> 23) & 0xff) - 127;
+    float m = fmBits((bits & 0x7fffff) | 0x3f800000);
+    if (m > FM_SQRT2) { m *= 0.5f; e++; }
+    return (float)e + fmLog2Poly<L>(m);
+}
+
+template <int L = FASTMATH_DEFAULT>
+static inline float fastPow(float x, float y) { return fastExp2<L>(y*fastLog2<L>(x)); }
+
+template <int L = FASTMATH_DEFAULT>
+static inline float fastTanh(float x) {
+    float a = fabsf(x), t;
+    if (a < 0.1f) t = a - a*a*a*(1.f/3.f - a*a*(2.f/15.f));
+    else t = (a > 9.f) ? 1.f : 1.f - 2.f/(fastExp2<L>(a*(2.f*FM_LOG2E)) + 1.f);
+    return (x < 0.f) ? -t : t;
+}
+
+// Scalar forms by sample type, for code templated on it: the polynomials for
+// float, libm for double and wider (the levels stop at float precision)
+template <int L = FASTMATH_DEFAULT> static inline float sampleSin(float x) { return fastSin<L>(x); }
+template <int L = FASTMATH_DEFAULT> static inline double sampleSin(double x) { return sin(x); }
+template <int L = FASTMATH_DEFAULT> static inline long double sampleSin(long double x) { return sinl(x); }
+template <int L = FASTMATH_DEFAULT> static inline float sampleCos(float x) { return fastCos<L>(x); }
+template <int L = FASTMATH_DEFAULT> static inline double sampleCos(double x) { return cos(x); }
+template <int L = FASTMATH_DEFAULT> static inline long double sampleCos(long double x) { return cosl(x); }
+template <int L = FASTMATH_DEFAULT> static inline float sampleTan(float x) { return fastTan<L>(x); }
+template <int L = FASTMATH_DEFAULT> static inline double sampleTan(double x) { return tan(x); }
+template <int L = FASTMATH_DEFAULT> static inline long double sampleTan(long double x) { return tanl(x); }
+template <int L = FASTMATH_DEFAULT> static inline float sampleLog2(float x) { return fastLog2<L>(x); }
+template <int L = FASTMATH_DEFAULT> static inline double sampleLog2(double x) { return log2(x); }
+template <int L = FASTMATH_DEFAULT> static inline long double sampleLog2(long double x) { return log2l(x); }
+
+#endif // FASTMATH_H
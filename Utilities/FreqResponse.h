@@ -0,0 +1,130 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   FreqResponse.h
+ *
+ *   Description:   Magnitude and phase of a biquad cascade on a log-frequency grid
+ *                  Evaluates four bins per vector from precomputed tables, and only
+ *                  when the caller's coefficient version changes. Written around
+ *                  1 - cos w so low cutoffs don't cancel in float near DC
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef FREQRESPONSE_H
+#define FREQRESPONSE_H
+
+#include <math.h>
+#include <vector>
+
+#include "SIMD.h"
+#include "SOSCascade.h"
+
+class FreqResponse {
+public:
+    // Initializations (bins is rounded up to a multiple of 4)
+    FreqResponse(int _bins, float _srate, float _fmin = 20.f) {
+        bins = (_bins + 3) & ~3;
+        srate = _srate;
+        fmin = _fmin;
+        version = 0;
+        valid = false;
+
+        freq.resize(bins);
+        ver1.resize(bins); ver2.resize(bins); sin1.resize(bins);
+        re.resize(bins); im.resize(bins);
+        mag.resize(bins); phase.resize(bins);
+
+        // Log spaced from fmin to Nyquist
+        double ratio = (srate/2)/fmin;
+        for (int i = 0; i < bins; i++) {
+            freq[i] = fmin*pow(ratio, (double)i/(bins - 1));
+            double w = 2*M_PI*freq[i]/srate;
+            ver1[i] = 2*sin(w/2)*sin(w/2);      // 1 - cos w
+            ver2[i] = 2*sin(w)*sin(w);          // 1 - cos 2w
+            sin1[i] = sin(w);
+        }
+    };
+    ~FreqResponse() {};
+
+    // Getters
+    int getBins() { return bins; };
+    float getMinFrequency() { return fmin; };
+    float getMaxFrequency() { return srate/2; };
+    const float *getFrequency() { return &freq[0]; };
+    const float *getMagnitude() { return &mag[0]; };      // dB
+    const float *getPhase() { return &phase[0]; };        // radians, wrapped
+
+    /*
+     *  Name: update(const SOSSection *sos, int n, unsigned int _version)
+     *  Desc: Recomputes the response if _version differs from the cached one,
+     *        returns true when it did
+     */
+    bool update(const SOSSection *sos, int n, unsigned int _version) {
+        if (valid && _version == version) return false;
+        version = _version;
+        valid = true;
+
+        // H(e^jw) = prod (b0 + b1 e^-jw + b2 e^-2jw) / (1 + a1 e^-jw + a2 e^-2jw)
+        // With u1 = 1 - cos w, u2 = 1 - cos 2w and sin 2w = 2 sin w (1 - u1):
+        //   re = (b0 + b1 + b2) - b1 u1 - b2 u2
+        //   im = -sin w ((b1 + 2 b2) - 2 b2 u1)
+        // The sums are formed once per section in double; near DC they are the
+        // small numbers that 1 + a1 cos w + a2 cos 2w loses in float
+        for (int i = 0; i < bins; i += 4) {
+            v4sf u1 = v4load(&ver1[i]), u2 = v4load(&ver2[i]), s1 = v4load(&sin1[i]);
+            v4sf hr = v4set1(1.f), hi = v4set1(0.f);
+
+            for (int s = 0; s < n; s++) {
+                v4sf b1 = v4set1(sos[s].b1), b2 = v4set1(sos[s].b2);
+                v4sf a1 = v4set1(sos[s].a1), a2 = v4set1(sos[s].a2);
+                v4sf bs = v4set1((float)((double)sos[s].b0 + sos[s].b1 + sos[s].b2));
+                v4sf bd = v4set1((float)((double)sos[s].b1 + 2.0*sos[s].b2));
+                v4sf as = v4set1((float)(1.0 + sos[s].a1 + sos[s].a2));
+                v4sf ad = v4set1((float)((double)sos[s].a1 + 2.0*sos[s].a2));
+
+                v4sf nr = bs - b1*u1 - b2*u2;
+                v4sf ni = -s1*(bd - v4set1(2.f)*b2*u1);
+                v4sf dr = as - a1*u1 - a2*u2;
+                v4sf di = -s1*(ad - v4set1(2.f)*a2*u1);
+
+                // N/D = N*conj(D)/|D|^2
+                v4sf inv = v4set1(1.f)/(dr*dr + di*di);
+                v4sf qr = (nr*dr + ni*di)*inv;
+                v4sf qi = (ni*dr - nr*di)*inv;
+
+                v4sf tr = hr*qr - hi*qi;
+                hi = hr*qi + hi*qr;
+                hr = tr;
+            }
+
+            v4store(&re[i], hr);
+            v4store(&im[i], hi);
+        }
+
+        for (int i = 0; i < bins; i++) {
+            mag[i] = 10.f*log10f(re[i]*re[i] + im[i]*im[i] + 1e-20f);
+            phase[i] = atan2f(im[i], re[i]);
+        }
+        return true;
+    };
+
+private:
+    int bins;
+    float srate, fmin;
+    unsigned int version;
+    bool valid;
+
+    std::vector<float> freq;
+    std::vector<float> ver1, ver2, sin1;            // per bin, fixed
+    std::vector<float> re, im;                      // scratch
+    std::vector<float> mag, phase;                  // cached result
+};
+
+#endif // FREQRESPONSE_H
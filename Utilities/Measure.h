@@ -0,0 +1,363 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   Measure.h
+ *
+ *   Description:   Streaming signal measurements
+ *                  RMS, peak, DC and crest factor from running sums over a
+ *                  sliding window (O(new samples) per update), zero-crossing
+ *                  and autocorrelation frequency, and THD+N from the FFT.
+ *                  MeasureEngine runs it on an analysis thread fed by the audio
+ *                  callback and publishes the readouts as triple-buffered snapshots
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef MEASURE_H
+#define MEASURE_H
+
+#include <math.h>
+#include <string.h>
+#include <unistd.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "SIMD.h"
+#include "FFT.h"
+#include "RingBuffer.h"
+#include "TripleBuffer.h"
+
+#define MEASURE_CHUNK           256             // Samples per peak-hold chunk
+#define MEASURE_NOTCH           6               // Bins either side of the fundamental (and DC) removed for THD+N
+
+// One set of readouts
+struct Measurements {
+    float rms;                  // dBFS
+    float peak;                 // dBFS
+    float dc;                   // linear
+    float crest;                // dB
+    float zcFreq;               // Hz, 0 if no crossings
+    float acFreq;               // Hz, 0 if no periodicity
+    float thdn;                 // dB relative to the total
+    unsigned long long samples; // total measured
+};
+
+class Measure {
+public:
+    // Initializations (_window: power of two, multiple of MEASURE_CHUNK)
+    Measure(float _srate, int _window = 8192) : fftWin(_window), fftAc(2*_window) {
+        srate = _srate;
+        window = _window;
+        ring.assign(window, 0.f);
+        chunkMax.assign(window/MEASURE_CHUNK, 0.f);
+        crossings.resize(window/2 + 1);
+
+        frame.resize(2*window);
+        re.resize(window + 4);
+        im.resize(window + 4);
+        power.resize(window + 4);
+        acf.resize(window + 4);
+
+        // 4-term Blackman-Harris (-92 dB sidelobes) for THD+N
+        bh.resize(window);
+        for (int i = 0; i < window; i++) {
+            double w = 2*M_PI*i/window;
+            bh[i] = 0.35875 - 0.48829*cos(w) + 0.14128*cos(2*w) - 0.01168*cos(3*w);
+        }
+        reset();
+    };
+    ~Measure() {};
+
+    // Clears all history
+    void reset() {
+        memset(&ring[0], 0, sizeof(float)*window);
+        memset(&chunkMax[0], 0, sizeof(float)*chunkMax.size());
+        pos = 0;
+        sum = sumSq = 0.0;
+        total = 0;
+        sinceResum = 0;
+        crossHead = crossCount = 0;
+        prev = 0.f;
+        armed = false;
+    };
+
+    /*
+     *  Name: push(const float *x, int n)
+     *  Desc: Slides the window over n new samples, updating the running sums,
+     *        chunk peaks and zero crossings for only the samples that changed
+     */
+    void push(const float *x, int n) {
+        // Hysteresis from the current level, so noise doesn't add crossings
+        float hyst = 0.1f*sqrtf(fmaxf(0.f, (float)(sumSq/window - (sum/window)*(sum/window))));
+
+        while (n > 0) {
+            int len = window - pos;
+            if (len > n) len = n;
+
+            // Out with the old, in with the new, four at a time
+            float *dst = &ring[pos];
+            v4sf s = v4set1(0.f), q = v4set1(0.f);
+            int i = 0;
+            for (; i + 4 <= len; i += 4) {
+                v4sf in = v4load(x + i), out = v4load(dst + i);
+                s += in - out;
+                q += in*in - out*out;
+            }
+            double ds = v4sum(s), dq = v4sum(q);
+            for (; i < len; i++) {
+                ds += x[i] - dst[i];
+                dq += x[i]*x[i] - dst[i]*dst[i];
+            }
+            sum += ds;
+            sumSq += dq;
+
+            for (i = 0; i < len; i++) {
+                // Rising crossing of zero, interpolated between samples
+                float v = x[i];
+                if (v < -hyst) armed = true;
+                else if (armed && v >= 0.f && prev < 0.f) {
+                    addCrossing(total + i - 1 + prev/(prev - v));
+                    armed = false;
+                }
+                prev = v;
+            }
+            memcpy(dst, x, sizeof(float)*len);
+
+            // Peak of every chunk that was touched
+            for (int c = pos/MEASURE_CHUNK; c <= (pos + len - 1)/MEASURE_CHUNK; c++)
+                chunkMax[c] = absMax(&ring[c*MEASURE_CHUNK], MEASURE_CHUNK);
+
+            pos = (pos + len) & (window - 1);
+            total += len;
+            sinceResum += len;
+            x += len;
+            n -= len;
+        }
+
+        // Drop crossings that slid out of the window
+        while (crossCount > 0 && crossings[(crossHead - crossCount + crossings.size()) % crossings.size()] < (double)total - window)
+            crossCount--;
+
+        // Re-sum exactly once per window length, so rounding never accumulates
+        if (sinceResum >= (unsigned long long)window) {
+            sinceResum = 0;
+            v4sf s = v4set1(0.f), q = v4set1(0.f);
+            for (int i = 0; i < window; i += 4) {
+                v4sf v = v4load(&ring[i]);
+                s += v;
+                q += v*v;
+            }
+            sum = v4sum(s);
+            sumSq = v4sum(q);
+        }
+    };
+
+    /*
+     *  Name: analyze(Measurements *m)
+     *  Desc: Readouts for the current window. The level statistics come straight
+     *        from the running sums; frequency and THD+N need the window's FFTs.
+     */
+    void analyze(Measurements *m) {
+        double mean = sum/window, ms = sumSq/window;
+        float pk = 0.f;
+        for (unsigned int c = 0; c < chunkMax.size(); c++) pk = fmaxf(pk, chunkMax[c]);
+
+        m->samples = total;
+        m->dc = (float)mean;
+        m->rms = (float)(10.0*log10(ms + 1e-20));
+        m->peak = 20.f*log10f(pk + 1e-10f);
+        m->crest = m->peak - m->rms;
+
+        // Zero crossing frequency: crossings per second across the ones we kept
+        m->zcFreq = 0.f;
+        if (crossCount >= 2) {
+            int size = crossings.size();
+            double first = crossings[(crossHead - crossCount + size) % size];
+            double last = crossings[(crossHead - 1 + size) % size];
+            m->zcFreq = (float)((crossCount - 1)*srate/(last - first));
+        }
+
+        // Window in time order, DC removed
+        int i;
+        for (i = 0; i < window; i++) frame[i] = ring[(pos + i) & (window - 1)] - (float)mean;
+
+        m->thdn = thdn();
+        m->acFreq = autocorrelationFrequency();
+    };
+
+private:
+    static float absMax(const float *x, int n) {
+        float m0 = 0.f, m1 = 0.f, m2 = 0.f, m3 = 0.f;
+        for (int i = 0; i < n; i += 4) {
+            m0 = fmaxf(m0, fabsf(x[i]));
+            m1 = fmaxf(m1, fabsf(x[i + 1]));
+            m2 = fmaxf(m2, fabsf(x[i + 2]));
+            m3 = fmaxf(m3, fabsf(x[i + 3]));
+        }
+        return fmaxf(fmaxf(m0, m1), fmaxf(m2, m3));
+    };
+
+    void addCrossing(double t) {
+        crossings[crossHead] = t;
+        crossHead = (crossHead + 1) % crossings.size();
+        if (crossCount < (int)crossings.size()) crossCount++;
+    };
+
+    // Power spectrum of frame[0..n) into power[0..n/2]
+    void powerSpectrum(FFT *fft, const float *x, int n) {
+        fft->realForward(x, &re[0], &im[0]);
+        int bins = n/2 + 1, k = 0;
+        for (; k + 4 <= bins; k += 4) {
+            v4sf r = v4load(&re[k]), m = v4load(&im[k]);
+            v4store(&power[k], r*r + m*m);
+        }
+        for (; k < bins; k++) power[k] = re[k]*re[k] + im[k]*im[k];
+    };
+
+    // Everything but the fundamental, relative to everything (DC excluded)
+    float thdn() {
+        std::vector<float> &x = acf;
+        for (int i = 0; i < window; i += 4) v4store(&x[i], v4load(&frame[i])*v4load(&bh[i]));
+        powerSpectrum(&fftWin, &x[0], window);
+
+        int bins = window/2 + 1, fund = MEASURE_NOTCH + 1;
+        for (int k = fund; k < bins; k++) if (power[k] > power[fund]) fund = k;
+
+        double all = 0.0, f = 0.0;
+        for (int k = MEASURE_NOTCH + 1; k < bins; k++) {
+            all += power[k];
+            if (k >= fund - MEASURE_NOTCH && k <= fund + MEASURE_NOTCH) f += power[k];
+        }
+        if (all <= 1e-20) return 0.f;
+        return (float)(10.0*log10((all - f)/all + 1e-20));
+    };
+
+    // Period from the autocorrelation (inverse FFT of the zero-padded power spectrum)
+    float autocorrelationFrequency() {
+        memset(&frame[window], 0, sizeof(float)*window);
+        powerSpectrum(&fftAc, &frame[0], 2*window);
+
+        // The spectrum is real and even, so a forward transform of it is the inverse
+        int n = 2*window;
+        for (int k = 0; k <= window; k++) frame[k] = power[k];
+        for (int k = 1; k < window; k++) frame[n - k] = power[k];
+        fftAc.realForward(&frame[0], &acf[0], &im[0]);
+        if (acf[0] <= 1e-12f) return 0.f;
+
+        // Skip the zero-lag lobe, then the first peak close to the highest one
+        // (a multiple of a short period can land nearer a whole lag and win)
+        int lag = 1, maxLag = window/2;
+        while (lag < maxLag && acf[lag] > 0.f) lag++;
+        float highest = 0.f;
+        for (int t = lag; t < maxLag; t++) highest = fmaxf(highest, acf[t]);
+        if (highest < 0.3f*acf[0]) return 0.f;
+
+        int best = 0;
+        for (int t = lag; t < maxLag && best == 0; t++)
+            if (acf[t] > acf[t - 1] && acf[t] >= acf[t + 1] && acf[t] >= 0.9f*highest) best = t;
+        if (best == 0) return 0.f;
+
+        // Parabolic interpolation around the peak
+        float a = acf[best - 1], b = acf[best], c = acf[best + 1];
+        float d = a - 2.f*b + c;
+        float offset = (d != 0.f) ? 0.5f*(a - c)/d : 0.f;
+        return srate/(best + offset);
+    };
+
+    FFT fftWin, fftAc;
+    float srate;
+    int window;
+
+    std::vector<float> ring;            // last window samples, pos is the oldest
+    int pos;
+    double sum, sumSq;
+    unsigned long long total, sinceResum;
+    std::vector<float> chunkMax;        // |x| max per MEASURE_CHUNK of the ring
+
+    std::vector<double> crossings;      // absolute times of rising crossings (circular)
+    int crossHead, crossCount;
+    float prev;
+    bool armed;
+
+    std::vector<float> bh, frame, re, im, power, acf;
+};
+
+class MeasureEngine {
+public:
+    // Initializations
+    // _ringSize: samples buffered between audio and analysis thread
+    // _interval: seconds between published readouts
+    MeasureEngine(float _srate, unsigned int _ringSize, float _interval = 0.1f)
+            : measure(_srate), results(Measurements()) {
+        ring = new RingBuffer<float>(_ringSize);
+        chunk.resize(_ringSize);
+        interval = (unsigned long long)(_interval*_srate);
+        running = false;
+    };
+    ~MeasureEngine() {
+        stop();
+        delete ring;
+    };
+
+    // Start/stop the analysis thread (not from the audio thread)
+    void start() {
+        if (running) return;
+        ring->flush();
+        running = true;
+        analysis = std::thread(&MeasureEngine::analysisLoop, this);
+    };
+    void stop() {
+        if (!running) return;
+        running = false;
+        analysis.join();
+    };
+
+    // Audio thread: queue one block, dropped if the analysis thread is behind
+    void pushBlock(const float *buf, unsigned long frames) {
+        if (running.load(std::memory_order_relaxed)) ring->write(buf, frames);
+    };
+
+    // GUI thread: newest readouts
+    const Measurements &read() {
+        bool changed;
+        return results.read(&changed);
+    };
+
+private:
+    void analysisLoop() {
+        unsigned long long due = interval;
+        while (running) {
+            unsigned int n = ring->read(&chunk[0], chunk.size());
+            if (n == 0) {
+                usleep(5000);
+                continue;
+            }
+            measure.push(&chunk[0], n);
+
+            if ((due = (due > n) ? due - n : 0) == 0) {
+                measure.analyze(&results.edit());
+                results.publish();
+                due = interval;
+            }
+        }
+    };
+
+    Measure measure;
+    TripleBuffer<Measurements> results;
+    RingBuffer<float> *ring;
+    std::vector<float> chunk;
+    unsigned long long interval;
+
+    // Threads Management
+    std::thread analysis;
+    std::atomic<bool> running;
+};
+
+#endif // MEASURE_H
@@ -0,0 +1,189 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   Persistence.h
+ *
+ *   Description:   Intensity-graded persistence, like a digital phosphor scope
+ *                  Every waveform adds hits to a 2D histogram (time x amplitude)
+ *                  that decays exponentially per frame and is mapped to a colour
+ *                  ramp. Binning computes four rows per vector and is split by
+ *                  column range across worker threads, so no two threads ever
+ *                  touch the same cells and nothing needs merging.
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef PERSISTENCE_H
+#define PERSISTENCE_H
+
+#include <math.h>
+#include <string.h>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "SIMD.h"
+#include "Raster.h"
+
+class Persistence {
+public:
+    // Initializations
+    // _cols x _rows histogram, _span samples per waveform, _threads workers
+    Persistence(int _cols, int _rows, int _span, int _threads) {
+        cols = _cols;
+        rows = _rows;
+        span = (_span + 3) & ~3;
+        numThreads = (_threads > 0) ? _threads : 1;
+
+        hist.assign(cols*rows, 0.f);
+        colOf.resize(span);
+        for (int i = 0; i < span; i++) colOf[i] = (int)((long long)i*cols/span);
+
+        Raster::heatRamp(ramp);
+
+        samples = NULL;
+        starts = NULL;
+        count = 0;
+        generation = 0;
+        pending = 0;
+        quit = false;
+        for (int t = 0; t < numThreads; t++) workers.push_back(std::thread(&Persistence::workerLoop, this, t));
+    };
+    ~Persistence() {
+        {
+            std::lock_guard<std::mutex> lock(jobLock);
+            quit = true;
+        }
+        jobReady.notify_all();
+        for (unsigned int t = 0; t < workers.size(); t++) workers[t].join();
+    };
+
+    // Getters
+    int getColumns() { return cols; };
+    int getRows() { return rows; };
+    int getSpan() { return span; };
+    int getThreads() { return numThreads; };
+
+    // Clears the histogram
+    void clear() { memset(&hist[0], 0, sizeof(float)*hist.size()); };
+
+    /*
+     *  Name: accumulate(const float *_samples, const int *_starts, int _count)
+     *  Desc: Adds _count waveforms of span samples, starting at _samples + _starts[k].
+     *        Amplitude -1..1 maps to the rows. Returns when all workers are done.
+     */
+    void accumulate(const float *_samples, const int *_starts, int _count) {
+        if (_count <= 0) return;
+        {
+            std::lock_guard<std::mutex> lock(jobLock);
+            samples = _samples;
+            starts = _starts;
+            count = _count;
+            pending = numThreads;
+            generation++;
+        }
+        jobReady.notify_all();
+
+        std::unique_lock<std::mutex> lock(jobLock);
+        jobDone.wait(lock, [this] { return pending == 0; });
+    };
+
+    // Exponential decay, once per displayed frame
+    void decay(float factor) {
+        v4sf f = v4set1(factor);
+        int n = hist.size(), i = 0;
+        for (; i + 4 <= n; i += 4) v4store(&hist[i], v4load(&hist[i])*f);
+        for (; i < n; i++) hist[i] *= factor;
+    };
+
+    /*
+     *  Name: render(unsigned int *rgba)
+     *  Desc: Colour-ramped image, rows x cols RGBA with row 0 at the bottom.
+     *        Log intensity relative to the busiest cell.
+     */
+    void render(unsigned int *rgba) {
+        float peak = 0.f;
+        for (unsigned int i = 0; i < hist.size(); i++) peak = fmaxf(peak, hist[i]);
+        float scale = (peak > 0.f) ? 255.f/logf(1.f + peak) : 0.f;
+
+        for (int c = 0; c < cols; c++) {
+            const float *column = &hist[c*rows];
+            for (int r = 0; r < rows; r++) {
+                int level = (int)(logf(1.f + column[r])*scale);
+                rgba[r*cols + c] = ramp[level > 255 ? 255 : level];
+            }
+        }
+    };
+
+private:
+    // Worker t bins the sample range that lands in its share of the columns
+    void bin(int t) {
+        int c0 = t*cols/numThreads, c1 = (t + 1)*cols/numThreads;
+        int i0 = 0, i1 = span;
+        while (i0 < span && colOf[i0] < c0) i0++;
+        while (i1 > i0 && colOf[i1 - 1] >= c1) i1--;
+
+        const v4sf scale = v4set1(0.5f*rows), offset = v4set1(0.5f*rows);
+        float *h = &hist[0];
+        for (int k = 0; k < count; k++) {
+            const float *wave = samples + starts[k];
+            int i = i0;
+
+            // Four rows per vector, then scatter the hits
+            for (; i + 4 <= i1; i += 4) {
+                v4si row = __builtin_convertvector(v4load(wave + i)*scale + offset, v4si);
+                for (int j = 0; j < 4; j++) {
+                    int r = row[j];
+                    if (r >= 0 && r < rows) h[colOf[i + j]*rows + r] += 1.f;
+                }
+            }
+            for (; i < i1; i++) {
+                int r = (int)(wave[i]*0.5f*rows + 0.5f*rows);
+                if (r >= 0 && r < rows) h[colOf[i]*rows + r] += 1.f;
+            }
+        }
+    };
+
+    void workerLoop(int t) {
+        unsigned int seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(jobLock);
+                jobReady.wait(lock, [&] { return quit || generation != seen; });
+                if (quit) return;
+                seen = generation;
+            }
+
+            bin(t);
+
+            std::lock_guard<std::mutex> lock(jobLock);
+            if (--pending == 0) jobDone.notify_one();
+        }
+    };
+
+    int cols, rows, span, numThreads;
+    std::vector<float> hist;            // column-major: hist[col*rows + row]
+    std::vector<int> colOf;             // sample index -> column
+    unsigned int ramp[256];
+
+    // Current job
+    const float *samples;
+    const int *starts;
+    int count;
+
+    std::vector<std::thread> workers;
+    std::mutex jobLock;
+    std::condition_variable jobReady, jobDone;
+    unsigned int generation;
+    int pending;
+    bool quit;
+};
+
+#endif // PERSISTENCE_H
@@ -0,0 +1,107 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   Probe.h
+ *
+ *   Description:   Named signal probes
+ *                  A probe is a point in the signal path with its own capture
+ *                  ring. The audio thread checks one atomic per probe per block
+ *                  and only copies samples while some trace subscribes, so an
+ *                  unwatched probe costs nothing in the render loop.
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef PROBE_H
+#define PROBE_H
+
+#include <string.h>
+#include <atomic>
+
+#include "RingBuffer.h"
+
+#define PROBE_MAX               16              // Probes in one set (bits of the active mask)
+
+class Probe {
+public:
+    // Initializations (_ringSize samples between audio and display)
+    Probe(const char *_name, unsigned int _ringSize) {
+        name = _name;
+        ring = new RingBuffer<float>(_ringSize);
+        subscribers = 0;
+        dropped = 0;
+    };
+    ~Probe() { delete ring; };
+
+    // Getters
+    const char *getName() { return name; };
+    unsigned int getDropped() { return dropped.load(std::memory_order_relaxed); };
+    bool isActive() { return subscribers.load(std::memory_order_relaxed) > 0; };
+
+    // Display thread: start/stop watching. The first subscriber starts from
+    // an empty ring, so it never sees samples from an earlier subscription.
+    void subscribe() {
+        if (subscribers.load(std::memory_order_relaxed) == 0) ring->flush();
+        subscribers.fetch_add(1, std::memory_order_relaxed);
+    };
+    void unsubscribe() {
+        if (subscribers.load(std::memory_order_relaxed) > 0) subscribers.fetch_sub(1, std::memory_order_relaxed);
+    };
+
+    // Audio thread: one block, dropped whole if the display has fallen behind
+    void push(const float *buf, unsigned long n) {
+        if (!ring->write(buf, n)) dropped.fetch_add(1, std::memory_order_relaxed);
+    };
+
+    // Display thread: up to n of the oldest queued samples
+    unsigned int read(float *dst, unsigned int n) { return ring->read(dst, n); };
+
+private:
+    const char *name;
+    RingBuffer<float> *ring;
+    std::atomic<int> subscribers;
+    std::atomic<unsigned int> dropped;
+};
+
+class ProbeSet {
+public:
+    // Initializations
+    ProbeSet() { count = 0; };
+    ~ProbeSet() { for (int i = 0; i < count; i++) delete probes[i]; };
+
+    // Adds a probe (not while rendering), returns its id or -1 when full
+    int add(const char *name, unsigned int ringSize) {
+        if (count >= PROBE_MAX) return -1;
+        probes[count] = new Probe(name, ringSize);
+        return count++;
+    };
+
+    // Getters
+    int getCount() { return count; };
+    Probe *get(int id) { return probes[id]; };
+
+    // Id of a probe by name, -1 if there is none
+    int find(const char *name) {
+        for (int i = 0; i < count; i++) if (!strcmp(probes[i]->getName(), name)) return i;
+        return -1;
+    };
+
+    // Audio thread: bit id set for every watched probe (once per block)
+    unsigned int getActive() {
+        unsigned int mask = 0;
+        for (int i = 0; i < count; i++) if (probes[i]->isActive()) mask |= 1u << i;
+        return mask;
+    };
+
+private:
+    Probe *probes[PROBE_MAX];
+    int count;
+};
+
+#endif // PROBE_H
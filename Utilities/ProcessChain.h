@@ -0,0 +1,336 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   ProcessChain.h
+ *
+ *   Description:   Hot-swappable processing chain
+ *                  The GUI thread builds a new chain from a preallocated node pool
+ *                  and submits it; the audio thread swaps it in at the next block
+ *                  boundary and crossfades from the old one; a reclaimer thread
+ *                  returns the old chain's nodes to the pool. The audio thread only
+ *                  exchanges pointers and never allocates, frees or locks.
+ *                  Each filter stage runs in float or, for precision-critical
+ *                  designs (low cutoff, high Q), in double. The chain runs a
+ *                  sample at a time, so a double stage converts per sample; the
+ *                  biquad's recursion costs more than the conversion does.
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef PROCESSCHAIN_H
+#define PROCESSCHAIN_H
+
+#include <stdio.h>
+#include <unistd.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "OscGen.h"
+#include "BiquadFilter.h"
+#include "RingBuffer.h"
+
+#define CHAIN_MAX_NODES         8           // Processors per chain
+
+// One processor in a chain
+typedef struct {
+    int type;               // ProcessChain::NODE
+    int tap;                // Tap id recorded after this node (-1 = none)
+    OscGen *osc;
+    BiquadFilter *filter;
+    BiquadFilterT<double> *filter64;    // Instead of filter for a DOUBLE stage
+} ChainNode;
+
+// A complete chain, owned by one thread at a time
+typedef struct {
+    ChainNode nodes[CHAIN_MAX_NODES];
+    int count;
+    unsigned int tag;       // Builder's id for the layout, reported by getTag()
+} Chain;
+
+class ProcessChain {
+public:
+    // Node Type
+    enum NODE {
+        OSC = 0,            // Source, replaces its input
+        FILTER = 1,         // Biquad
+    };
+
+    // Sample type of a filter stage
+    enum PRECISION {
+        SINGLE = 0,         // BiquadFilter
+        DOUBLE = 1,         // BiquadFilterT<double>, converted per sample
+    };
+
+    // Initializations
+    // _fadeFrames: crossfade length when a new chain is swapped in
+    // _chains/_oscs/_filters/_filters64: pool sizes, everything is allocated here
+    ProcessChain(float _srate, int _fadeFrames, int _chains = 8, int _oscs = 8, int _filters = 32, int _filters64 = 32) {
+        srate = _srate;
+        fadeFrames = (_fadeFrames > 0) ? _fadeFrames : 1;
+
+        chains = new Chain[_chains];
+        freeChains.reserve(_chains);
+        for (int i = 0; i < _chains; i++) freeChains.push_back(&chains[i]);
+
+        for (int i = 0; i < _oscs; i++) oscs.push_back(new OscGen(srate));
+        freeOscs = oscs;
+
+        for (int i = 0; i < _filters; i++) filters.push_back(new BiquadFilter(srate));
+        freeFilters = filters;
+
+        for (int i = 0; i < _filters64; i++) filters64.push_back(new BiquadFilterT<double>(srate));
+        freeFilters64 = filters64;
+
+        // Every chain fits, so the audio thread can always retire
+        retired = new RingBuffer<Chain *>(_chains);
+        pending = NULL;
+        current = NULL;
+        fading = NULL;
+        fadePos = 0;
+        freq = 0.f;
+        swaps = 0;
+        reclaimed = 0;
+
+        running = true;
+        reclaimer = std::thread(&ProcessChain::reclaimLoop, this);
+    };
+    ~ProcessChain() {
+        running = false;
+        reclaimer.join();
+        delete retired;
+        delete [] chains;
+        for (unsigned int i = 0; i < oscs.size(); i++) delete oscs[i];
+        for (unsigned int i = 0; i < filters.size(); i++) delete filters[i];
+        for (unsigned int i = 0; i < filters64.size(); i++) delete filters64[i];
+    };
+
+    /*
+     *  GUI thread: building
+     */
+
+    // Empty chain from the pool, NULL when exhausted
+    Chain *create() {
+        std::lock_guard<std::mutex> lock(poolLock);
+        if (freeChains.empty()) return NULL;
+        Chain *c = freeChains.back();
+        freeChains.pop_back();
+        c->count = 0;
+        c->tag = 0;
+        return c;
+    };
+
+    // Appends an oscillator, false when the chain or pool is full
+    bool addOsc(Chain *c, int waveform, int tap) {
+        std::lock_guard<std::mutex> lock(poolLock);
+        if (c->count >= CHAIN_MAX_NODES || freeOscs.empty()) return false;
+        OscGen *osc = freeOscs.back();
+        freeOscs.pop_back();
+        osc->reset();
+        osc->setWaveform(waveform);
+
+        ChainNode node = { OSC, tap, osc, NULL, NULL };
+        c->nodes[c->count++] = node;
+        return true;
+    };
+
+    // Appends a biquad running in the given PRECISION, false when the chain
+    // or that pool is full
+    bool addFilter(Chain *c, int type, float fc, float q, int tap, int precision = SINGLE) {
+        std::lock_guard<std::mutex> lock(poolLock);
+        if (c->count >= CHAIN_MAX_NODES) return false;
+
+        ChainNode node = { FILTER, tap, NULL, NULL, NULL };
+        if (precision == DOUBLE) {
+            if (freeFilters64.empty()) return false;
+            node.filter64 = freeFilters64.back();
+            freeFilters64.pop_back();
+            configure(node.filter64, type, fc, q);
+        }
+        else {
+            if (freeFilters.empty()) return false;
+            node.filter = freeFilters.back();
+            freeFilters.pop_back();
+            configure(node.filter, type, fc, q);
+        }
+        c->nodes[c->count++] = node;
+        return true;
+    };
+
+    // Chains left in the pool (the reclaimer refills it)
+    int getFreeChains() {
+        std::lock_guard<std::mutex> lock(poolLock);
+        return (int)freeChains.size();
+    };
+
+    // Returns a chain that was never submitted
+    void discard(Chain *c) { release(c); };
+
+    // Hands a chain to the audio thread for the next block boundary. A chain
+    // still waiting from an earlier submit was never seen by audio, drop it here.
+    void submit(Chain *c) {
+        Chain *old = pending.exchange(c, std::memory_order_acq_rel);
+        if (old != NULL) release(old);
+    };
+
+    /*
+     *  Audio thread
+     */
+
+    // Picks up a submitted chain once the previous crossfade has finished,
+    // true when one was swapped in
+    bool beginBlock() {
+        if (fading != NULL || pending.load(std::memory_order_relaxed) == NULL) return false;
+        Chain *next = pending.exchange(NULL, std::memory_order_acq_rel);
+        if (next == NULL) return false;
+
+        setChainFrequency(next, freq);
+        fading = current;
+        current = next;
+        fadePos = 0;
+        swaps.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    };
+
+    // Offline renders: takes a pending chain without the crossfade (the old
+    // one is retired) and puts every node back to its initial state, so the
+    // next block starts cold
+    void restart() {
+        Chain *next = pending.exchange(NULL, std::memory_order_acq_rel);
+        if (next != NULL) {
+            if (current != NULL) retired->write(&current, 1);
+            setChainFrequency(next, freq);
+            current = next;
+            swaps.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (fading != NULL) {
+            retired->write(&fading, 1);
+            fading = NULL;
+        }
+        if (current == NULL) return;
+        for (int i = 0; i < current->count; i++) {
+            ChainNode *node = &current->nodes[i];
+            if (node->type == OSC) node->osc->reset();
+            else if (node->filter64 != NULL) node->filter64->reset();
+            else node->filter->reset();
+        }
+    };
+
+    // Runs one sample through the chain. enabled is a bitmask of (1 << NODE),
+    // taps one of (1 << tap): each node tagged with a tap in it writes its
+    // output to tapOut[tap].
+    float process(float in, unsigned int enabled, unsigned int taps, float *tapOut) {
+        if (current == NULL) return in;
+        float out = run(current, in, enabled, taps, tapOut);
+        if (fading == NULL) return out;
+
+        float g = (float)fadePos / fadeFrames;
+        out = g*out + (1.f - g)*run(fading, in, enabled, 0, NULL);
+        if (++fadePos >= fadeFrames) {
+            retired->write(&fading, 1);
+            fading = NULL;
+        }
+        return out;
+    };
+
+    // Note frequency for every oscillator, carried over to new chains
+    void setFrequency(float _freq) {
+        freq = _freq;
+        if (current != NULL) setChainFrequency(current, freq);
+        if (fading != NULL) setChainFrequency(fading, freq);
+    };
+
+    // Getters
+    unsigned int getTag() { return (current != NULL) ? current->tag : 0; };   // audio thread
+    unsigned int getSwaps() { return swaps.load(); };
+    unsigned int getReclaimed() { return reclaimed.load(); };
+
+private:
+    float run(Chain *c, float sample, unsigned int enabled, unsigned int taps, float *tapOut) {
+        for (int i = 0; i < c->count; i++) {
+            ChainNode *node = &c->nodes[i];
+            if (enabled & (1u << node->type)) {
+                if (node->type == OSC) sample = node->osc->generateSample();
+                else if (node->filter64 != NULL) sample = (float)node->filter64->processBiquad(sample);
+                else sample = node->filter->processBiquad(sample);
+            }
+            if (node->tap >= 0 && (taps & (1u << node->tap))) tapOut[node->tap] = sample;
+        }
+        return sample;
+    };
+
+    template <typename Sample>
+    static void configure(BiquadFilterT<Sample> *filter, int type, float fc, float q) {
+        filter->reset();
+        filter->setCutoffFrequency(fc);
+        filter->setQ(q);
+        filter->setFilterType(type);
+        filter->configureFilter();      // type may match the node's last use
+    };
+
+    void setChainFrequency(Chain *c, float f) {
+        for (int i = 0; i < c->count; i++)
+            if (c->nodes[i].type == OSC) c->nodes[i].osc->setFrequency(f);
+    };
+
+    // Nodes and chain back to the pool (never from the audio thread)
+    void release(Chain *c) {
+        std::lock_guard<std::mutex> lock(poolLock);
+        for (int i = 0; i < c->count; i++) {
+            if (c->nodes[i].type == OSC) freeOscs.push_back(c->nodes[i].osc);
+            else if (c->nodes[i].filter64 != NULL) freeFilters64.push_back(c->nodes[i].filter64);
+            else freeFilters.push_back(c->nodes[i].filter);
+        }
+        c->count = 0;
+        freeChains.push_back(c);
+    };
+
+    // Reclaimer thread: returns chains the audio thread has retired
+    void reclaimLoop() {
+        Chain *c;
+        while (running) {
+            while (retired->read(&c, 1) == 1) {
+                release(c);
+                reclaimed.fetch_add(1, std::memory_order_relaxed);
+            }
+            usleep(10000);
+        }
+    };
+
+    float srate;
+    int fadeFrames;
+
+    // Pool (GUI and reclaimer threads)
+    Chain *chains;
+    std::vector<Chain *> freeChains;
+    std::vector<OscGen *> freeOscs;
+    std::vector<BiquadFilter *> freeFilters;
+    std::vector<BiquadFilterT<double> *> freeFilters64;
+    std::vector<OscGen *> oscs;             // everything allocated, for the destructor
+    std::vector<BiquadFilter *> filters;
+    std::vector<BiquadFilterT<double> *> filters64;
+    std::mutex poolLock;
+
+    // Handoff
+    std::atomic<Chain *> pending;       // GUI -> audio
+    RingBuffer<Chain *> *retired;       // audio -> reclaimer
+
+    // Audio thread only
+    Chain *current, *fading;
+    int fadePos;
+    float freq;
+
+    std::atomic<unsigned int> swaps;
+    std::atomic<unsigned int> reclaimed;
+    std::thread reclaimer;
+    std::atomic<bool> running;
+};
+
+#endif // PROCESSCHAIN_H
@@ -0,0 +1,267 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   Raster.h
+ *
+ *   Description:   CPU framebuffer renderer for headless scope frames
+ *                  RGBA8 pixels, SIMD span fills, anti-aliased lines of any
+ *                  width, and PNG / raw video export with no GL or window
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef RASTER_H
+#define RASTER_H
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+
+#include "SIMD.h"
+
+// Pixel as stored in memory: R, G, B, A bytes
+#define RASTER_RGB(r, g, b)     ((unsigned int)(r) | ((unsigned int)(g) << 8) | ((unsigned int)(b) << 16) | 0xff000000u)
+
+class Raster {
+public:
+    // Initializations
+    Raster(int _width, int _height) {
+        width = _width;
+        height = _height;
+        pixels.resize(width*height);
+
+        // CRC table for PNG chunks
+        for (unsigned int n = 0; n < 256; n++) {
+            unsigned int c = n;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            crcTable[n] = c;
+        }
+    };
+    ~Raster() {};
+
+    // Getters
+    int getWidth() { return width; };
+    int getHeight() { return height; };
+    const unsigned int *getPixels() { return &pixels[0]; };
+
+    // Whole frame to one colour
+    void clear(unsigned int color) { fillSpan(&pixels[0], width*height, color); };
+
+    // Opaque horizontal run [x0, x1) on row y
+    void fillRow(int y, int x0, int x1, unsigned int color) {
+        if (y < 0 || y >= height) return;
+        if (x0 < 0) x0 = 0;
+        if (x1 > width) x1 = width;
+        if (x1 > x0) fillSpan(&pixels[y*width + x0], x1 - x0, color);
+    };
+
+    // Opaque vertical run [y0, y1) on column x
+    void fillColumn(int x, int y0, int y1, unsigned int color) {
+        if (x < 0 || x >= width) return;
+        if (y0 < 0) y0 = 0;
+        if (y1 > height) y1 = height;
+        for (int y = y0; y < y1; y++) pixels[y*width + x] = color;
+    };
+
+    // Blends color over one pixel with coverage a (0..1)
+    void blendPixel(int x, int y, unsigned int color, float a) {
+        if (x < 0 || x >= width || y < 0 || y >= height || a <= 0.f) return;
+        unsigned int &d = pixels[y*width + x];
+        if (a >= 1.f) { d = color; return; }
+
+        // R and B blended together in one multiply, G on its own
+        unsigned int w = (unsigned int)(a*256.f);
+        unsigned int rb = (((d & 0xff00ffu)*(256 - w) + (color & 0xff00ffu)*w) >> 8) & 0xff00ffu;
+        unsigned int g = (((d & 0xff00u)*(256 - w) + (color & 0xff00u)*w) >> 8) & 0xff00u;
+        d = 0xff000000u | rb | g;
+    };
+
+    /*
+     *  Name: drawLine(float x0, float y0, float x1, float y1, float lineWidth, unsigned int color)
+     *  Desc: Anti-aliased line in pixel coordinates. Steps along the major axis and
+     *        covers the minor axis span of the line's thickness at that step, so
+     *        each pixel's weight is its overlap with the line.
+     */
+    void drawLine(float x0, float y0, float x1, float y1, float lineWidth, unsigned int color) {
+        bool steep = fabsf(y1 - y0) > fabsf(x1 - x0);
+        if (steep) { swap(&x0, &y0); swap(&x1, &y1); }
+        if (x0 > x1) { swap(&x0, &x1); swap(&y0, &y1); }
+
+        float slope = (x1 == x0) ? 0.f : (y1 - y0)/(x1 - x0);
+        float half = 0.5f*lineWidth*sqrtf(1.f + slope*slope);
+        int start = (int)floorf(x0 + 0.5f), end = (int)floorf(x1 + 0.5f);
+
+        for (int x = start; x <= end; x++) {
+            float c = y0 + slope*(x + 0.5f - x0);
+            float lo = c - half, hi = c + half;
+            int ylo = (int)floorf(lo), yhi = (int)floorf(hi);
+            if (ylo == yhi) {
+                plot(steep, x, ylo, color, hi - lo);
+                continue;
+            }
+
+            // Partial ends, fully covered pixels in between
+            plot(steep, x, ylo, color, ylo + 1.f - lo);
+            for (int y = ylo + 1; y < yhi; y++) plot(steep, x, y, color, 1.f);
+            plot(steep, x, yhi, color, hi - yhi);
+        }
+    };
+
+    // Connected line through n points
+    void drawPolyline(const float *xs, const float *ys, int n, float lineWidth, unsigned int color) {
+        for (int i = 0; i + 1 < n; i++) drawLine(xs[i], ys[i], xs[i + 1], ys[i + 1], lineWidth, color);
+    };
+
+    // Scope graticule over pixel rect [x0, x1] x [y0, y1]: divX x divY divisions,
+    // centre axes in axisColor
+    void drawGraticule(int x0, int y0, int x1, int y1, int divX, int divY, unsigned int color, unsigned int axisColor) {
+        for (int i = 0; i <= divX; i++)
+            fillColumn(x0 + i*(x1 - x0)/divX, y0, y1 + 1, (2*i == divX) ? axisColor : color);
+        for (int i = 0; i <= divY; i++)
+            fillRow(y0 + i*(y1 - y0)/divY, x0, x1 + 1, (2*i == divY) ? axisColor : color);
+    };
+
+    // 256-entry intensity ramp: black -> blue -> cyan -> yellow -> red -> white
+    static void heatRamp(unsigned int *ramp) {
+        static const float stops[][3] = { { 0, 0, 0 }, { 0, 0, 1 }, { 0, 1, 1 }, { 1, 1, 0 }, { 1, 0, 0 }, { 1, 1, 1 } };
+        for (int i = 0; i < 256; i++) {
+            float t = i/255.f*5.f;
+            int s = (t >= 5.f) ? 4 : (int)t;
+            float f = t - s;
+            ramp[i] = RASTER_RGB(255.f*(stops[s][0] + f*(stops[s + 1][0] - stops[s][0])),
+                                 255.f*(stops[s][1] + f*(stops[s + 1][1] - stops[s][1])),
+                                 255.f*(stops[s][2] + f*(stops[s + 1][2] - stops[s][2])));
+        }
+    };
+
+    // Appends the frame to a raw RGBA video stream
+    // (ffmpeg -f rawvideo -pix_fmt rgba -s WxH -i file)
+    bool writeRaw(FILE *f) {
+        return fwrite(&pixels[0], sizeof(unsigned int), pixels.size(), f) == pixels.size();
+    };
+
+    /*
+     *  Name: writePNG(const char *path)
+     *  Desc: RGBA PNG with stored (uncompressed) deflate blocks, no zlib needed
+     */
+    bool writePNG(const char *path) {
+        FILE *f = fopen(path, "wb");
+        if (f == NULL) {
+            printf("[raster]: could not open %s\n", path);
+            return false;
+        }
+
+        static const unsigned char sig[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+        fwrite(sig, 1, 8, f);
+
+        unsigned char ihdr[13];
+        put32(ihdr, width);
+        put32(ihdr + 4, height);
+        ihdr[8] = 8;        // bit depth
+        ihdr[9] = 6;        // RGBA
+        ihdr[10] = ihdr[11] = ihdr[12] = 0;
+        writeChunk(f, "IHDR", ihdr, 13);
+
+        // Scanlines with filter byte 0
+        unsigned int rowBytes = width*4 + 1;
+        raw.resize(rowBytes*height);
+        for (int y = 0; y < height; y++) {
+            raw[y*rowBytes] = 0;
+            memcpy(&raw[y*rowBytes + 1], &pixels[y*width], width*4);
+        }
+
+        // zlib stream of stored blocks
+        unsigned int total = raw.size(), blocks = (total + 65534)/65535;
+        zbuf.resize(2 + 5*blocks + total + 4);
+        unsigned char *z = &zbuf[0];
+        *z++ = 0x78; *z++ = 0x01;
+        for (unsigned int pos = 0; pos < total; pos += 65535) {
+            unsigned int n = (total - pos < 65535) ? total - pos : 65535;
+            *z++ = (pos + n == total) ? 1 : 0;
+            *z++ = n & 0xff; *z++ = n >> 8;
+            *z++ = ~n & 0xff; *z++ = (~n >> 8) & 0xff;
+            memcpy(z, &raw[pos], n);
+            z += n;
+        }
+
+        // Adler-32, reduced every 5552 bytes (largest run that can't overflow)
+        unsigned int a = 1, b = 0;
+        for (unsigned int pos = 0; pos < total; ) {
+            unsigned int end = (total - pos < 5552) ? total : pos + 5552;
+            for (; pos < end; pos++) { a += raw[pos]; b += a; }
+            a %= 65521;
+            b %= 65521;
+        }
+        put32(z, (b << 16) | a);
+
+        writeChunk(f, "IDAT", &zbuf[0], zbuf.size());
+        writeChunk(f, "IEND", NULL, 0);
+
+        bool ok = !ferror(f);
+        fclose(f);
+        return ok;
+    };
+
+    // FNV-1a of the pixels, for image regression checks
+    unsigned int checksum() {
+        unsigned int h = 2166136261u;
+        const unsigned char *p = (const unsigned char *)&pixels[0];
+        for (size_t i = 0; i < pixels.size()*4; i++) h = (h ^ p[i])*16777619u;
+        return h;
+    };
+
+private:
+    // n pixels to one colour, 16 per iteration
+    static void fillSpan(unsigned int *dst, int n, unsigned int color) {
+        v4su v = v4uset1(color);
+        int i = 0;
+        for (; i + 16 <= n; i += 16) {
+            v4ustore(dst + i, v);
+            v4ustore(dst + i + 4, v);
+            v4ustore(dst + i + 8, v);
+            v4ustore(dst + i + 12, v);
+        }
+        for (; i + 4 <= n; i += 4) v4ustore(dst + i, v);
+        for (; i < n; i++) dst[i] = color;
+    };
+
+    // Major/minor axis to x/y
+    void plot(bool steep, int major, int minor, unsigned int color, float a) {
+        if (steep) blendPixel(minor, major, color, a);
+        else blendPixel(major, minor, color, a);
+    };
+
+    static void swap(float *a, float *b) { float t = *a; *a = *b; *b = t; };
+
+    static void put32(unsigned char *p, unsigned int v) {
+        p[0] = v >> 24; p[1] = (v >> 16) & 0xff; p[2] = (v >> 8) & 0xff; p[3] = v & 0xff;
+    };
+
+    void writeChunk(FILE *f, const char *type, const unsigned char *data, unsigned int n) {
+        unsigned char len[4], crcBytes[4];
+        put32(len, n);
+        fwrite(len, 1, 4, f);
+        fwrite(type, 1, 4, f);
+        if (n > 0) fwrite(data, 1, n, f);
+
+        unsigned int crc = 0xffffffffu;
+        for (int i = 0; i < 4; i++) crc = crcTable[(crc ^ (unsigned char)type[i]) & 0xff] ^ (crc >> 8);
+        for (unsigned int i = 0; i < n; i++) crc = crcTable[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+        put32(crcBytes, crc ^ 0xffffffffu);
+        fwrite(crcBytes, 1, 4, f);
+    };
+
+    int width, height;
+    std::vector<unsigned int> pixels;
+    std::vector<unsigned char> raw, zbuf;   // PNG scratch, reused per frame
+    unsigned int crcTable[256];
+};
+
+#endif // RASTER_H
@@ -0,0 +1,231 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   RealTime.h
+ *
+ *   Description:   Real-time safety for the audio thread
+ *                  - flush denormals to zero (FTZ/DAZ) on the calling thread
+ *                  - SCHED_FIFO priority where the OS permits it
+ *                  - locked and pre-faulted memory
+ *                  - RT_DEBUG builds abort on malloc/free/new/delete, mutex locks
+ *                    and blocking calls made inside an RTScope, so a hot-path
+ *                    regression fails loudly instead of glitching
+ *
+ *                  The RT_DEBUG hooks replace global functions, so this header
+ *                  must only be included from one translation unit (main.cpp).
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef REALTIME_H
+#define REALTIME_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <atomic>
+#include <new>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <xmmintrin.h>
+#endif
+
+#define RT_PREFAULT_STACK       (256*1024)      // Stack touched on the audio thread
+#define RT_SETUP_PENDING        -1              // g_rt_setup before the callback's first entry
+
+// Nesting depth of RTScope on this thread (> 0 means "in the callback")
+static thread_local int g_rt_depth = 0;
+
+// Outcome of the audio thread's setup (0 or the SCHED_FIFO error), reported
+// by the thread that started the stream instead of printed from the callback
+static std::atomic<int> g_rt_setup(RT_SETUP_PENDING);
+
+/*
+ *  Name: rtViolation(const char *what)
+ *  Desc: Reports a forbidden call from real-time code and aborts
+ */
+static inline void rtViolation(const char *what) {
+    g_rt_depth = 0;     // the report itself must not trap
+    static const char msg[] = "[realtime]: forbidden call in audio callback: ";
+    if (write(2, msg, sizeof(msg) - 1) < 0 || write(2, what, strlen(what)) < 0 || write(2, "\n", 1) < 0) {}
+    abort();
+}
+
+// Marks a region as real-time for the RT_DEBUG traps
+class RTScope {
+public:
+    RTScope() { g_rt_depth++; };
+    ~RTScope() { g_rt_depth--; };
+};
+
+#define RT_CHECK(what)      do { if (g_rt_depth > 0) rtViolation(what); } while (0)
+
+/*
+ *  Name: enableFlushToZero()
+ *  Desc: Denormals become zero on this thread (per-thread FPU state)
+ */
+static inline void enableFlushToZero() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_setcsr(_mm_getcsr() | 0x8040);          // FTZ | DAZ
+#elif defined(__aarch64__)
+    unsigned long long fpcr;
+    __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+    __asm__ __volatile__("msr fpcr, %0" :: "r"(fpcr | (1ULL << 24)));  // FZ
+#endif
+}
+
+/*
+ *  Name: requestRealtimePriority()
+ *  Desc: SCHED_FIFO for the calling thread, 0 or the error if not permitted
+ *        (safe on the audio thread, prints nothing)
+ */
+static inline int requestRealtimePriority() {
+    struct sched_param param;
+    param.sched_priority = sched_get_priority_max(SCHED_FIFO) - 1;
+    return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+}
+
+/*
+ *  Name: lockMemory()
+ *  Desc: Keeps current and future pages resident, 0 or errno if not permitted
+ */
+static inline int lockMemory() {
+    return (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) ? errno : 0;
+}
+
+/*
+ *  Name: prefaultStack()
+ *  Desc: Touches the stack the callback may grow into
+ */
+static inline void prefaultStack() {
+    volatile char stack[RT_PREFAULT_STACK];
+    for (int i = 0; i < RT_PREFAULT_STACK; i += 4096) stack[i] = 0;
+    (void)stack[0];
+}
+
+/*
+ *  Name: enterRealtimeThread()
+ *  Desc: One-time setup the first time a thread runs the callback; its
+ *        outcome is published in g_rt_setup for reportRealtimeSetup()
+ */
+static inline void enterRealtimeThread(bool realtime) {
+    static thread_local int result = RT_SETUP_PENDING;
+    if (result == RT_SETUP_PENDING) {
+        enableFlushToZero();
+        result = 0;
+        if (realtime) {
+            result = requestRealtimePriority();
+            prefaultStack();
+        }
+    }
+    if (g_rt_setup.load(std::memory_order_relaxed) == RT_SETUP_PENDING)
+        g_rt_setup.store(result, std::memory_order_relaxed);
+}
+
+/*
+ *  Name: reportRealtimeSetup(int timeoutMs)
+ *  Desc: Waits for the callback's first entry after a stream start (the
+ *        caller resets g_rt_setup before starting it) and prints how its
+ *        real-time setup went. Not for the audio thread.
+ */
+static inline void reportRealtimeSetup(int timeoutMs) {
+    int err;
+    for (int t = 0; (err = g_rt_setup.load()) == RT_SETUP_PENDING && t < timeoutMs; t++) usleep(1000);
+    if (err == RT_SETUP_PENDING) printf("[realtime]: no callback within %d ms, SCHED_FIFO unknown\n", timeoutMs);
+    else if (err != 0) printf("[realtime]: SCHED_FIFO not permitted (%s)\n", strerror(err));
+}
+
+#ifdef RT_DEBUG
+/*
+ *  RT_DEBUG allocation traps
+ */
+void *operator new(size_t size) {
+    RT_CHECK("operator new");
+    void *p = malloc(size ? size : 1);
+    if (p == NULL) throw std::bad_alloc();
+    return p;
+}
+void *operator new[](size_t size) {
+    RT_CHECK("operator new[]");
+    void *p = malloc(size ? size : 1);
+    if (p == NULL) throw std::bad_alloc();
+    return p;
+}
+void operator delete(void *p) noexcept { RT_CHECK("operator delete"); free(p); }
+void operator delete[](void *p) noexcept { RT_CHECK("operator delete[]"); free(p); }
+void operator delete(void *p, size_t) noexcept { RT_CHECK("operator delete"); free(p); }
+void operator delete[](void *p, size_t) noexcept { RT_CHECK("operator delete[]"); free(p); }
+
+#if defined(__GLIBC__)
+#include <dlfcn.h>
+
+// glibc: the executable's definitions interpose libc's for every library
+extern "C" {
+void *__libc_malloc(size_t);
+void *__libc_calloc(size_t, size_t);
+void *__libc_realloc(void *, size_t);
+void __libc_free(void *);
+
+void *malloc(size_t size) { RT_CHECK("malloc"); return __libc_malloc(size); }
+void *calloc(size_t n, size_t size) { RT_CHECK("calloc"); return __libc_calloc(n, size); }
+void *realloc(void *p, size_t size) { RT_CHECK("realloc"); return __libc_realloc(p, size); }
+void free(void *p) { RT_CHECK("free"); __libc_free(p); }
+
+// Locks and blocking calls, forwarded to the next definition
+#define RT_FORWARD(ret, name, params, args)                                 \
+    ret name params {                                                       \
+        RT_CHECK(#name);                                                    \
+        static ret (*next) params = (ret (*) params)dlsym(RTLD_NEXT, #name);\
+        return next args;                                                   \
+    }
+RT_FORWARD(int, pthread_mutex_lock, (pthread_mutex_t *m), (m))
+RT_FORWARD(int, pthread_cond_wait, (pthread_cond_t *c, pthread_mutex_t *m), (c, m))
+RT_FORWARD(int, nanosleep, (const struct timespec *req, struct timespec *rem), (req, rem))
+RT_FORWARD(int, usleep, (useconds_t usec), (usec))
+RT_FORWARD(ssize_t, read, (int fd, void *buf, size_t n), (fd, buf, n))
+RT_FORWARD(ssize_t, write, (int fd, const void *buf, size_t n), (fd, buf, n))
+}
+
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#include <mach/mach.h>
+
+// macOS: wrap the default malloc zone (covers malloc/calloc/realloc/free)
+static void *(*rt_zone_malloc)(malloc_zone_t *, size_t);
+static void *(*rt_zone_calloc)(malloc_zone_t *, size_t, size_t);
+static void *(*rt_zone_realloc)(malloc_zone_t *, void *, size_t);
+static void (*rt_zone_free)(malloc_zone_t *, void *);
+
+static void *rtZoneMalloc(malloc_zone_t *z, size_t s) { RT_CHECK("malloc"); return rt_zone_malloc(z, s); }
+static void *rtZoneCalloc(malloc_zone_t *z, size_t n, size_t s) { RT_CHECK("calloc"); return rt_zone_calloc(z, n, s); }
+static void *rtZoneRealloc(malloc_zone_t *z, void *p, size_t s) { RT_CHECK("realloc"); return rt_zone_realloc(z, p, s); }
+static void rtZoneFree(malloc_zone_t *z, void *p) { RT_CHECK("free"); rt_zone_free(z, p); }
+
+__attribute__((constructor)) static void rtInstallZoneHooks() {
+    malloc_zone_t *zone = malloc_default_zone();
+    vm_protect(mach_task_self(), (vm_address_t)zone, sizeof(*zone), 0, VM_PROT_READ | VM_PROT_WRITE);
+    rt_zone_malloc = zone->malloc;
+    rt_zone_calloc = zone->calloc;
+    rt_zone_realloc = zone->realloc;
+    rt_zone_free = zone->free;
+    zone->malloc = rtZoneMalloc;
+    zone->calloc = rtZoneCalloc;
+    zone->realloc = rtZoneRealloc;
+    zone->free = rtZoneFree;
+    vm_protect(mach_task_self(), (vm_address_t)zone, sizeof(*zone), 0, VM_PROT_READ);
+}
+#endif
+#endif // RT_DEBUG
+
+#endif // REALTIME_H
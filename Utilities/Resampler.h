@@ -0,0 +1,175 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   Resampler.h
+ *
+ *   Description:   Streaming polyphase sample-rate converter
+ *                  Kaiser-windowed sinc table with linear interpolation between
+ *                  phases, so any ratio works with a fixed table size
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include <math.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "SIMD.h"
+
+class Resampler {
+public:
+    // Initializations
+    // _taps: filter length per phase at the lower of the two rates
+    //        (stretched when downsampling, rounded up to a multiple of 4)
+    // _phases: table resolution between two input samples
+    // _maxBlock: largest input block handed to process()
+    Resampler(double _inRate, double _outRate, int _taps = 32, int _phases = 256, int _maxBlock = 4096) {
+        inRate = _inRate;
+        outRate = _outRate;
+        ratio = outRate < inRate ? outRate / inRate : 1.0;
+        baseTaps = _taps;
+        taps = ((int)ceil(_taps / ratio) + 3) & ~3;
+        phases = _phases;
+        step = (uint64_t)(inRate / outRate * 4294967296.0 + 0.5);
+
+        coefs = new float[(phases + 1)*taps];
+        bufCap = 2*(taps + _maxBlock);
+        buf = new float[bufCap];
+        design();
+        reset();
+    };
+    ~Resampler() {
+        delete [] coefs;
+        delete [] buf;
+    };
+
+    // Clears the history, output starts after getLatency() input samples
+    void reset() {
+        memset(buf, 0, sizeof(float)*bufCap);
+        bufLen = taps - 1;
+        pos = 0;
+    };
+
+    // Getters
+    double getInputRate() { return inRate; };
+    double getOutputRate() { return outRate; };
+    int getTaps() { return taps; };
+    int getLatency() { return taps/2; };
+
+    // Input samples still needed before outCount outputs can be produced
+    int inputRequired(int outCount) {
+        if (outCount <= 0) return 0;
+        int64_t last = (int64_t)((pos + (uint64_t)(outCount - 1)*step) >> 32);
+        int64_t need = last + taps - bufLen;
+        return need > 0 ? (int)need : 0;
+    };
+
+    // Upper bound on outputs produced by inCount more input samples
+    int outputAvailable(int inCount) {
+        int64_t lim = (int64_t)bufLen + inCount - taps + 1;
+        if (lim <= 0) return 0;
+        uint64_t span = (uint64_t)lim << 32;
+        if (span <= pos) return 0;
+        return (int)((span - pos - 1) / step) + 1;
+    };
+
+    /*
+     *  Name: process(const float *in, int inCount, float *out, int maxOut, int *used)
+     *  Desc: Appends inCount samples, writes up to maxOut outputs, returns count.
+     *        Samples not yet consumed stay queued for the next call. Input past
+     *        the queue (callers within inputRequired() never get there) is not
+     *        taken; *used (if given) says how much was, so the caller can
+     *        count the dropout.
+     */
+    int process(const float *in, int inCount, float *out, int maxOut, int *used = NULL) {
+        if (bufLen + inCount > bufCap) inCount = bufCap - bufLen;
+        if (used != NULL) *used = inCount;
+        memcpy(buf + bufLen, in, sizeof(float)*inCount);
+        bufLen += inCount;
+
+        int n = 0;
+        while (n < maxOut) {
+            int ipos = (int)(pos >> 32);
+            if (ipos + taps > bufLen) break;
+
+            // Fractional position -> table row + interpolation weight
+            uint32_t frac = (uint32_t)pos;
+            uint64_t pf = (uint64_t)frac * phases;
+            int p = (int)(pf >> 32);
+            float t = (float)(uint32_t)pf * (1.f/4294967296.f);
+
+            const float *x = buf + ipos;
+            float y0 = dotProduct(x, coefs + p*taps, taps);
+            float y1 = dotProduct(x, coefs + (p + 1)*taps, taps);
+            out[n++] = y0 + (y1 - y0)*t;
+
+            pos += step;
+        }
+
+        // Drop samples that no output window needs anymore
+        int consumed = (int)(pos >> 32);
+        if (consumed > bufLen) consumed = bufLen;
+        memmove(buf, buf + consumed, sizeof(float)*(bufLen - consumed));
+        bufLen -= consumed;
+        pos -= (uint64_t)consumed << 32;
+
+        return n;
+    };
+
+    // Zeroth order modified Bessel function (Kaiser window, shared with SincDisplay)
+    static double besselI0(double x) {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 32; k++) {
+            term *= (x / (2.0*k)) * (x / (2.0*k));
+            sum += term;
+        }
+        return sum;
+    };
+
+private:
+    // Windowed sinc table, row p delays the window by p/phases samples
+    void design() {
+        // Kaiser beta 8 (~80dB) needs ~5/taps of transition, end it at the lower Nyquist
+        double fc = ratio * fmax(0.25, 0.5 - 2.5/baseTaps);
+        double beta = 8.0;
+        double half = taps / 2.0;
+        double i0beta = besselI0(beta);
+
+        for (int p = 0; p <= phases; p++) {
+            double frac = (double)p / phases;
+            double sum = 0;
+            for (int k = 0; k < taps; k++) {
+                double t = k - (half - 1) - frac;
+                double w = t / half;
+                double win = (fabs(w) < 1.0) ? besselI0(beta * sqrt(1.0 - w*w)) / i0beta : 0.0;
+                double sinc = (t == 0.0) ? 1.0 : sin(2.0*M_PI*fc*t) / (2.0*M_PI*fc*t);
+                double h = 2.0*fc * sinc * win;
+                coefs[p*taps + k] = (float)h;
+                sum += h;
+            }
+            // unity DC gain per phase
+            for (int k = 0; k < taps; k++) coefs[p*taps + k] = (float)(coefs[p*taps + k] / sum);
+        }
+    };
+
+    double inRate, outRate;
+    double ratio;           // cutoff relative to the input Nyquist
+    int baseTaps, taps, phases;
+    uint64_t step;          // input samples per output, 32.32 fixed point
+    uint64_t pos;           // read position in buf, 32.32 fixed point
+
+    float *coefs;           // (phases + 1) rows of taps
+    float *buf;             // queued input
+    int bufLen, bufCap;
+};
+
+#endif // RESAMPLER_H
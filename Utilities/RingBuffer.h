@@ -0,0 +1,96 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   RingBuffer.h
+ *
+ *   Description:   Lock-free single producer / single consumer ring buffer
+ *                  Safe to write from the audio callback, read from another thread
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include <string.h>
+#include <atomic>
+
+template <typename T>
+class RingBuffer {
+public:
+    // Initializations (capacity is rounded up to a power of two)
+    RingBuffer(unsigned int _capacity) {
+        size = 1;
+        while (size < _capacity) size <<= 1;
+        mask = size - 1;
+        buffer = new T[size];
+        memset(buffer, 0, sizeof(T)*size);
+        head = 0;
+        tail = 0;
+    };
+    ~RingBuffer() { delete [] buffer; };
+
+    // Getters
+    unsigned int capacity() { return size; };
+    unsigned int readAvailable() {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_relaxed);
+    };
+    unsigned int writeAvailable() {
+        return size - (head.load(std::memory_order_relaxed) - tail.load(std::memory_order_acquire));
+    };
+
+    // Producer: writes all n items or nothing
+    bool write(const T *src, unsigned int n) {
+        unsigned int h = head.load(std::memory_order_relaxed);
+        unsigned int t = tail.load(std::memory_order_acquire);
+        if (size - (h - t) < n) return false;
+
+        unsigned int start = h & mask;
+        unsigned int first = (n < size - start) ? n : size - start;
+        memcpy(buffer + start, src, sizeof(T)*first);
+        memcpy(buffer, src + first, sizeof(T)*(n - first));
+
+        head.store(h + n, std::memory_order_release);
+        return true;
+    };
+
+    // Consumer: reads up to n items, returns number read
+    unsigned int read(T *dst, unsigned int n) {
+        unsigned int t = tail.load(std::memory_order_relaxed);
+        unsigned int h = head.load(std::memory_order_acquire);
+        if (n > h - t) n = h - t;
+
+        unsigned int start = t & mask;
+        unsigned int first = (n < size - start) ? n : size - start;
+        memcpy(dst, buffer + start, sizeof(T)*first);
+        memcpy(dst + first, buffer, sizeof(T)*(n - first));
+
+        tail.store(t + n, std::memory_order_release);
+        return n;
+    };
+
+    // Consumer: copies the oldest item without consuming it
+    bool peek(T *dst) {
+        unsigned int t = tail.load(std::memory_order_relaxed);
+        if (head.load(std::memory_order_acquire) == t) return false;
+        *dst = buffer[t & mask];
+        return true;
+    };
+
+    // Consumer: drops everything currently queued
+    void flush() { tail.store(head.load(std::memory_order_acquire), std::memory_order_release); };
+
+private:
+    T *buffer;
+    unsigned int size, mask;
+    std::atomic<unsigned int> head;     // written by producer only
+    std::atomic<unsigned int> tail;     // written by consumer only
+};
+
+#endif // RINGBUFFER_H
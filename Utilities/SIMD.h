@@ -0,0 +1,115 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   SIMD.h
+ *
+ *   Description:   Portable 4-wide float vectors (2-wide double)
+ *                  Uses the GCC/Clang vector extension so the same code maps to
+ *                  SSE on Intel and NEON on ARM
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <string.h>
+
+// 4 floats in one register
+typedef float v4sf __attribute__((vector_size(16)));
+
+// Unaligned load/store
+static inline v4sf v4load(const float *p) { v4sf v; memcpy(&v, p, sizeof(v)); return v; }
+static inline void v4store(float *p, v4sf v) { memcpy(p, &v, sizeof(v)); }
+
+// Broadcast one value to all lanes
+static inline v4sf v4set1(float x) { v4sf v = { x, x, x, x }; return v; }
+
+// 4 unsigned ints (e.g. RGBA pixels) in one register
+typedef unsigned int v4su __attribute__((vector_size(16)));
+static inline v4su v4uset1(unsigned int x) { v4su v = { x, x, x, x }; return v; }
+static inline void v4ustore(unsigned int *p, v4su v) { memcpy(p, &v, sizeof(v)); }
+
+// 4 ints (e.g. bin indices, via __builtin_convertvector) in one register
+typedef int v4si __attribute__((vector_size(16)));
+
+// Horizontal sum
+static inline float v4sum(v4sf v) { return (v[0] + v[1]) + (v[2] + v[3]); }
+
+/*
+ *  Name: dotProduct(const float *a, const float *b, int n)
+ *  Desc: Inner product, n must be a multiple of 4
+ */
+static inline float dotProduct(const float *a, const float *b, int n) {
+    v4sf acc0 = v4set1(0.f), acc1 = v4set1(0.f);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 += v4load(a + i) * v4load(b + i);
+        acc1 += v4load(a + i + 4) * v4load(b + i + 4);
+    }
+    for (; i < n; i += 4) acc0 += v4load(a + i) * v4load(b + i);
+    return v4sum(acc0 + acc1);
+}
+
+// 2 doubles in one register
+typedef double v2df __attribute__((vector_size(16)));
+
+// 4 doubles (two registers), the float/double conversion width
+typedef double v4df __attribute__((vector_size(32)));
+
+/*
+ *  Register type and lane count for a sample type, so code templated on the
+ *  sample type keeps one register per step: 4 floats or 2 doubles
+ */
+template <typename T> struct SampleVec;
+
+template <> struct SampleVec<float> {
+    typedef v4sf type;
+    enum { WIDTH = 4 };
+    static inline v4sf load(const float *p) { return v4load(p); }
+    static inline void store(float *p, v4sf v) { v4store(p, v); }
+    static inline v4sf set1(float x) { return v4set1(x); }
+};
+
+template <> struct SampleVec<double> {
+    typedef v2df type;
+    enum { WIDTH = 2 };
+    static inline v2df load(const double *p) { v2df v; memcpy(&v, p, sizeof(v)); return v; }
+    static inline void store(double *p, v2df v) { memcpy(p, &v, sizeof(v)); }
+    static inline v2df set1(double x) { v2df v = { x, x }; return v; }
+};
+
+/*
+ *  Name: convertSamples(const float *in, double *out, int n)
+ *  Desc: Block conversion at a float/double boundary, four samples per step
+ *        (same-type overloads copy, so templated callers needn't special-case)
+ */
+static inline void convertSamples(const float *in, double *out, int n) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        v4df d = __builtin_convertvector(v4load(in + i), v4df);
+        memcpy(out + i, &d, sizeof(d));
+    }
+    for (; i < n; i++) out[i] = in[i];
+}
+
+static inline void convertSamples(const double *in, float *out, int n) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        v4df d;
+        memcpy(&d, in + i, sizeof(d));
+        v4store(out + i, __builtin_convertvector(d, v4sf));
+    }
+    for (; i < n; i++) out[i] = (float)in[i];
+}
+
+static inline void convertSamples(const float *in, float *out, int n) { if (in != out) memmove(out, in, sizeof(float)*n); }
+static inline void convertSamples(const double *in, double *out, int n) { if (in != out) memmove(out, in, sizeof(double)*n); }
+
+#endif // SIMD_H
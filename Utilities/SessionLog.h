@@ -0,0 +1,249 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   SessionLog.h
+ *
+ *   Description:   Session record and replay
+ *                  The audio thread logs everything that reaches the renderer -
+ *                  each block's input, control events, parameter snapshots and
+ *                  chain swaps, all stamped with sample times - into a byte ring
+ *                  that a writer thread streams to disk. Replaying the records
+ *                  in order re-runs the same blocks bit for bit, and a hash of
+ *                  each block's output proves it.
+ *
+ *                  File: SessionHeader, then records (SessionRecord + payload):
+ *                      SESSION_BLOCK        rendered block, no input used
+ *                      SESSION_BLOCK_INPUT  rendered block, arg floats of input
+ *                      SESSION_EVENT        a ControlEvent as applied
+ *                      SESSION_STATE        arg bytes of parameter snapshot
+ *                      SESSION_CHAIN        chain layout tag arg swapped in
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef SESSIONLOG_H
+#define SESSIONLOG_H
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "RingBuffer.h"
+#include "ControlQueue.h"
+
+#define SESSION_MAGIC           "GLSCOPE\x01"   // 8 bytes at the start of every session file
+#define SESSION_VERSION         1
+#define SESSION_HASH_SEED       2166136261u     // FNV-1a over the output bits
+
+// Record types
+enum SESSION_RECORD {
+    SESSION_BLOCK = 0,
+    SESSION_BLOCK_INPUT = 1,
+    SESSION_EVENT = 2,
+    SESSION_STATE = 3,
+    SESSION_CHAIN = 4,
+};
+
+typedef struct {
+    char magic[8];
+    unsigned int version;
+    float srate;                // Internal sample rate of the session
+} SessionHeader;
+
+typedef struct {
+    unsigned int type;          // SESSION_RECORD
+    unsigned int arg;           // Blocks: frames, STATE: bytes, CHAIN: layout tag
+    unsigned long long time;    // Sample time (blocks: first sample)
+    unsigned int hash;          // Blocks: hash of the rendered output
+    unsigned int size;          // Payload bytes that follow
+} SessionRecord;
+
+/*
+ *  Name: sessionHash(const float *buf, unsigned long n)
+ *  Desc: FNV-1a over the bit patterns of n samples (exact, -0 != +0)
+ */
+inline unsigned int sessionHash(const float *buf, unsigned long n) {
+    unsigned int h = SESSION_HASH_SEED;
+    for (unsigned long i = 0; i < n; i++) {
+        unsigned int bits;
+        memcpy(&bits, &buf[i], sizeof(bits));
+        h = (h ^ bits)*16777619u;
+    }
+    return h;
+}
+
+class SessionWriter {
+public:
+    // Initializations
+    // _ringSize: bytes of headroom between audio and writer thread
+    SessionWriter(unsigned int _ringSize) {
+        ring = new RingBuffer<unsigned char>(_ringSize);
+        chunk.resize(ring->capacity()/4);
+        file = NULL;
+        running = false;
+        failed = false;
+        failTime = 0;
+        written = 0;
+    };
+    ~SessionWriter() { close(); delete ring; };
+
+    /*
+     *  Name: open(const char *path, float srate)
+     *  Desc: Creates the file and starts the writer thread (not from the audio thread)
+     */
+    bool open(const char *path, float srate) {
+        if (running) return false;
+        if ((file = fopen(path, "wb")) == NULL) {
+            printf("[session]: could not open %s\n", path);
+            return false;
+        }
+
+        SessionHeader h;
+        memset(&h, 0, sizeof(h));
+        memcpy(h.magic, SESSION_MAGIC, sizeof(h.magic));
+        h.version = SESSION_VERSION;
+        h.srate = srate;
+        fwrite(&h, sizeof(h), 1, file);
+        written = sizeof(h);
+
+        failed = false;
+        running = true;
+        writer = std::thread(&SessionWriter::writerLoop, this);
+        return true;
+    };
+
+    // Drains the ring, joins the writer and closes the file
+    void close() {
+        if (!running) return;
+        running = false;
+        writer.join();
+        fclose(file);
+        file = NULL;
+        if (failed) printf("[session]: ring overflowed, replayable up to sample %llu only\n", failTime);
+        printf("[session]: %llu bytes written\n", written);
+    };
+
+    /*
+     *  Audio thread: never blocks or allocates. Once a record doesn't fit the
+     *  session can't be replayed past that point, so logging stops there.
+     */
+
+    void logEvent(const ControlEvent *ev) {
+        SessionRecord r = { SESSION_EVENT, 0, ev->time, 0, sizeof(ControlEvent) };
+        push(&r, ev);
+    };
+
+    void logState(unsigned long long time, const void *state, unsigned int size) {
+        SessionRecord r = { SESSION_STATE, size, time, 0, size };
+        push(&r, state);
+    };
+
+    void logChain(unsigned long long time, unsigned int tag) {
+        SessionRecord r = { SESSION_CHAIN, tag, time, 0, 0 };
+        push(&r, NULL);
+    };
+
+    // in is NULL when the block didn't use its input
+    void logBlock(unsigned long long time, const float *in, const float *out, unsigned long frames) {
+        SessionRecord r = { in ? SESSION_BLOCK_INPUT : SESSION_BLOCK, (unsigned int)frames, time,
+                            sessionHash(out, frames), in ? (unsigned int)(sizeof(float)*frames) : 0 };
+        push(&r, in);
+    };
+
+private:
+    void push(const SessionRecord *r, const void *payload) {
+        if (failed.load(std::memory_order_relaxed)) return;
+        if (ring->writeAvailable() < sizeof(*r) + r->size) {
+            failTime = r->time;
+            failed.store(true, std::memory_order_relaxed);
+            return;
+        }
+        ring->write((const unsigned char *)r, sizeof(*r));
+        if (r->size > 0) ring->write((const unsigned char *)payload, r->size);
+    };
+
+    // Writer thread: batches whatever is queued every 10 ms
+    void writerLoop() {
+        while (running) {
+            usleep(10000);
+            flush();
+        }
+        flush();
+    };
+
+    void flush() {
+        unsigned int n;
+        while ((n = ring->read(&chunk[0], chunk.size())) > 0) {
+            if (fwrite(&chunk[0], 1, n, file) != n) printf("[session]: write error\n");
+            written += n;
+        }
+    };
+
+    RingBuffer<unsigned char> *ring;
+    std::vector<unsigned char> chunk;
+    FILE *file;
+    unsigned long long written;
+
+    // Threads Management
+    std::thread writer;
+    std::atomic<bool> running;
+    std::atomic<bool> failed;
+    unsigned long long failTime;
+};
+
+class SessionReader {
+public:
+    // Initializations
+    SessionReader() { file = NULL; srate = 0; };
+    ~SessionReader() { if (file != NULL) fclose(file); };
+
+    // Opens a session file and checks its header
+    bool open(const char *path) {
+        SessionHeader h;
+        if ((file = fopen(path, "rb")) == NULL) {
+            printf("[session]: could not open %s\n", path);
+            return false;
+        }
+        if (fread(&h, sizeof(h), 1, file) != 1 || memcmp(h.magic, SESSION_MAGIC, sizeof(h.magic))) {
+            printf("[session]: %s is not a session file\n", path);
+            return false;
+        }
+        if (h.version != SESSION_VERSION) {
+            printf("[session]: %s is version %u, expected %d\n", path, h.version, SESSION_VERSION);
+            return false;
+        }
+        srate = h.srate;
+        return true;
+    };
+
+    // Getters
+    float getSampleRate() { return srate; };
+
+    /*
+     *  Name: next(SessionRecord *r)
+     *  Desc: Reads the next record, its payload at getPayload(). False at the
+     *        end of the file or on a record cut short.
+     */
+    bool next(SessionRecord *r) {
+        if (fread(r, sizeof(*r), 1, file) != 1) return false;
+        payload.resize(r->size + 1);
+        return r->size == 0 || fread(&payload[0], 1, r->size, file) == r->size;
+    };
+    const void *getPayload() { return &payload[0]; };
+
+private:
+    FILE *file;
+    float srate;
+    std::vector<unsigned char> payload;
+};
+
+#endif // SESSIONLOG_H
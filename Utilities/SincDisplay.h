@@ -0,0 +1,113 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   SincDisplay.h
+ *
+ *   Description:   Band-limited trace reconstruction for the scope
+ *                  Evaluates the sin(x)/x interpolation of a block at arbitrary
+ *                  fractional positions (one per pixel column), so a zoomed-in
+ *                  trace shows the signal between samples, true peaks included,
+ *                  instead of straight lines through them. Kaiser-windowed sinc
+ *                  table as in Resampler.h, cutoff at Nyquist so every curve
+ *                  passes exactly through its samples.
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef SINCDISPLAY_H
+#define SINCDISPLAY_H
+
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+#include "SIMD.h"
+#include "Resampler.h"
+
+#define SINC_DISPLAY_TAPS       32              // Samples per reconstructed point (multiple of 4)
+#define SINC_DISPLAY_PHASES     256             // Table rows between two samples
+#define SINC_DISPLAY_BETA       5.0             // Kaiser beta (error under -48 dB up to 0.45 fs)
+
+class SincDisplay {
+public:
+    // Initializations
+    SincDisplay(int _taps = SINC_DISPLAY_TAPS, int _phases = SINC_DISPLAY_PHASES) {
+        taps = (_taps + 3) & ~3;
+        phases = _phases;
+        coefs.resize((phases + 1)*taps);
+        edge.resize(taps);
+        design();
+    };
+
+    // Getters
+    int getTaps() { return taps; };
+
+    /*
+     *  Name: render(const float *x, int n, double start, double step, float *out, int count)
+     *  Desc: count points of the band-limited signal through x[0..n) at sample
+     *        positions start, start + step, ... Samples past either end count as
+     *        zero. Cost is taps multiply-adds per point, whatever the zoom.
+     */
+    void render(const float *x, int n, double start, double step, float *out, int count) {
+        int half = taps/2;
+        for (int j = 0; j < count; j++) {
+            double pos = start + j*step;
+            int i = (int)floor(pos);
+
+            // Fractional position -> table row + interpolation weight
+            double pf = (pos - i)*phases;
+            int p = (int)pf;
+            if (p >= phases) p = phases - 1;
+            float t = (float)(pf - p);
+
+            // Window x[i - half + 1 .. i + half], zero padded at the block edges
+            int first = i - half + 1;
+            const float *w = &edge[0];
+            if (first >= 0 && first + taps <= n) w = x + first;
+            else {
+                for (int k = 0; k < taps; k++)
+                    edge[k] = (first + k >= 0 && first + k < n) ? x[first + k] : 0.f;
+            }
+
+            float y0 = dotProduct(w, &coefs[p*taps], taps);
+            float y1 = dotProduct(w, &coefs[(p + 1)*taps], taps);
+            out[j] = y0 + (y1 - y0)*t;
+        }
+    };
+
+private:
+    // Windowed sinc table, row p delays the window by p/phases samples. At the
+    // Nyquist cutoff row 0 is a unit impulse, so samples are reproduced exactly.
+    void design() {
+        double half = taps / 2.0;
+        double i0beta = Resampler::besselI0(SINC_DISPLAY_BETA);
+
+        for (int p = 0; p <= phases; p++) {
+            double frac = (double)p / phases;
+            double sum = 0;
+            for (int k = 0; k < taps; k++) {
+                double t = k - (half - 1) - frac;
+                double w = t / half;
+                double win = (fabs(w) < 1.0) ? Resampler::besselI0(SINC_DISPLAY_BETA * sqrt(1.0 - w*w)) / i0beta : 0.0;
+                double sinc = (t == 0.0) ? 1.0 : sin(M_PI*t) / (M_PI*t);
+                double h = sinc * win;
+                coefs[p*taps + k] = (float)h;
+                sum += h;
+            }
+            // unity DC gain per phase
+            for (int k = 0; k < taps; k++) coefs[p*taps + k] = (float)(coefs[p*taps + k] / sum);
+        }
+    };
+
+    int taps, phases;
+    std::vector<float> coefs;   // (phases + 1) rows of taps
+    std::vector<float> edge;    // zero padded window at the block edges
+};
+
+#endif // SINCDISPLAY_H
@@ -0,0 +1,171 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   Spectrogram.h
+ *
+ *   Description:   Incremental STFT waterfall
+ *                  Runs one Hann-windowed FFT per hop as samples arrive and keeps
+ *                  the colour-mapped magnitude columns in a circular history, so
+ *                  a display only uploads the columns added since its last frame
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef SPECTROGRAM_H
+#define SPECTROGRAM_H
+
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+#include "SIMD.h"
+#include "FFT.h"
+#include "Raster.h"
+
+class Spectrogram {
+public:
+    // Initializations
+    // _fftSize (power of two) every _hop samples, _columns of history, _rows
+    // log-spaced from fmin to Nyquist, colours spanning floorDb..0 dBFS
+    Spectrogram(int _fftSize, int _hop, int _columns, int _rows, float _srate, float _fmin = 20.f, float _floorDb = -100.f)
+            : fft(_fftSize) {
+        fftSize = _fftSize;
+        hop = _hop;
+        columns = _columns;
+        rows = _rows;
+        floorDb = _floorDb;
+        fill = 0;
+        head = columns - 1;
+        pending = 0;
+
+        input.resize(fftSize);
+        frame.resize(fftSize);
+        re.resize(fftSize/2 + 4);
+        im.resize(fftSize/2 + 4);
+        power.resize(fftSize/2 + 4);
+        history.assign(columns*rows, 0xff000000u);
+        Raster::heatRamp(ramp);
+
+        // Hann window, scaled so a full-scale sine peaks at 0 dB
+        window.resize(fftSize);
+        float sum = 0.f;
+        for (int i = 0; i < fftSize; i++) {
+            window[i] = 0.5f - 0.5f*cosf(2.f*M_PI*i/fftSize);
+            sum += window[i];
+        }
+        for (int i = 0; i < fftSize; i++) window[i] *= 2.f/sum;
+
+        // Rows: band edges in bins, log spaced
+        binLo.resize(rows);
+        binHi.resize(rows);
+        centre.resize(rows);
+        float ratio = (_srate/2)/_fmin, binHz = _srate/fftSize;
+        for (int r = 0; r < rows; r++) {
+            float lo = _fmin*powf(ratio, (float)r/rows)/binHz;
+            float hi = _fmin*powf(ratio, (float)(r + 1)/rows)/binHz;
+            binLo[r] = (int)ceilf(lo);
+            binHi[r] = (int)floorf(hi);
+            if (binHi[r] > fftSize/2) binHi[r] = fftSize/2;
+            centre[r] = sqrtf(lo*hi);
+        }
+    };
+    ~Spectrogram() {};
+
+    // Getters
+    int getColumns() { return columns; };
+    int getRows() { return rows; };
+    int getHead() { return head; };                                     // newest column
+    const unsigned int *getColumn(int c) { return &history[c*rows]; };  // rows pixels, lowest frequency first
+
+    /*
+     *  Name: push(const float *x, int n)
+     *  Desc: Appends samples, computing a new column at every completed hop
+     */
+    void push(const float *x, int n) {
+        while (n > 0) {
+            int take = (fftSize - fill < n) ? fftSize - fill : n;
+            memcpy(&input[fill], x, sizeof(float)*take);
+            fill += take;
+            x += take;
+            n -= take;
+
+            if (fill == fftSize) {
+                computeColumn();
+                memmove(&input[0], &input[hop], sizeof(float)*(fftSize - hop));
+                fill -= hop;
+            }
+        }
+    };
+
+    /*
+     *  Name: takeNewColumns(int *first)
+     *  Desc: Number of columns added since the last call (at most the whole
+     *        history), first is the oldest of them
+     */
+    int takeNewColumns(int *first) {
+        int count = pending;
+        pending = 0;
+        *first = (head - count + 1 + columns) % columns;
+        return count;
+    };
+
+private:
+    void computeColumn() {
+        int i = 0;
+        for (; i + 4 <= fftSize; i += 4) v4store(&frame[i], v4load(&input[i])*v4load(&window[i]));
+        fft.realForward(&frame[0], &re[0], &im[0]);
+
+        int bins = fftSize/2 + 1;
+        for (i = 0; i + 4 <= bins; i += 4) {
+            v4sf r = v4load(&re[i]), m = v4load(&im[i]);
+            v4store(&power[i], r*r + m*m);
+        }
+        for (; i < bins; i++) power[i] = re[i]*re[i] + im[i]*im[i];
+
+        head = (head + 1) % columns;
+        unsigned int *column = &history[head*rows];
+        float scale = 255.f/-floorDb;
+
+        for (int r = 0; r < rows; r++) {
+            float p;
+            if (binHi[r] >= binLo[r]) {
+                // Band covers whole bins: loudest of them
+                p = 0.f;
+                for (int k = binLo[r]; k <= binHi[r]; k++) p = fmaxf(p, power[k]);
+            }
+            else {
+                // Narrower than a bin: interpolate at the band centre
+                int k = (int)centre[r];
+                float f = centre[r] - k;
+                p = power[k] + f*(power[k + 1] - power[k]);
+            }
+
+            int level = (int)((10.f*log10f(p + 1e-20f) - floorDb)*scale);
+            column[r] = ramp[level < 0 ? 0 : (level > 255 ? 255 : level)];
+        }
+
+        if (pending < columns) pending++;
+    };
+
+    FFT fft;
+    int fftSize, hop, columns, rows;
+    float floorDb;
+
+    std::vector<float> input;           // last fftSize samples, fill of them valid
+    int fill;
+    std::vector<float> window, frame, re, im, power;
+    std::vector<int> binLo, binHi;      // whole bins per row (empty if lo > hi)
+    std::vector<float> centre;          // fractional centre bin per row
+
+    std::vector<unsigned int> history;  // column-major: history[col*rows + row]
+    int head, pending;
+    unsigned int ramp[256];
+};
+
+#endif // SPECTROGRAM_H
@@ -0,0 +1,70 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   TripleBuffer.h
+ *
+ *   Description:   Lock-free triple buffer for parameter snapshots
+ *                  One writer (GUI) edits a private copy and publishes it with a
+ *                  single atomic exchange; one reader (audio) picks up the newest
+ *                  complete copy, costing one atomic load when nothing changed
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+
+template <typename T>
+class TripleBuffer {
+public:
+    // Initializations
+    TripleBuffer(const T &init) {
+        buffers[0] = buffers[1] = buffers[2] = init;
+        writeIdx = 0;
+        middle = 1;
+        readIdx = 2;
+    };
+
+    // Writer: the private copy to edit
+    T &edit() { return buffers[writeIdx]; };
+
+    // Writer: hand the edited copy to the reader, keep editing from it
+    void publish() {
+        unsigned int published = writeIdx;
+        unsigned int prev = middle.exchange(published | NEW_BIT, std::memory_order_acq_rel);
+        writeIdx = prev & INDEX_MASK;
+        buffers[writeIdx] = buffers[published];
+    };
+
+    // Reader: newest published copy, true in *changed if it is new this call
+    const T &read(bool *changed) {
+        *changed = false;
+        if (middle.load(std::memory_order_relaxed) & NEW_BIT) {
+            unsigned int prev = middle.exchange(readIdx, std::memory_order_acq_rel);
+            readIdx = prev & INDEX_MASK;
+            *changed = true;
+        }
+        return buffers[readIdx];
+    };
+
+private:
+    enum {
+        INDEX_MASK = 3,
+        NEW_BIT = 4,        // middle holds a copy the reader hasn't seen
+    };
+
+    T buffers[3];
+    unsigned int writeIdx;              // writer only
+    unsigned int readIdx;               // reader only
+    std::atomic<unsigned int> middle;   // exchanged between the two
+};
+
+#endif // TRIPLEBUFFER_H
@@ -23,9 +23,26 @@
 #include <OpenGL/glu.h>
 #include <GLUT/glut.h>
 
+#include <vector>
+#include "scope_view.h"
+#include "FreqResponse.h"
+#include "Persistence.h"
+#include "Spectrogram.h"
+#include "RingBuffer.h"
+#include "Probe.h"
+
 // GL Definitions
-#define INIT_WIDTH              900             // GL View Width
-#define INIT_HEIGHT             700             // GL View Height
+#define PERSIST_COLS            512             // Persistence histogram time bins
+#define PERSIST_ROWS            256             // Persistence histogram amplitude bins
+#define PERSIST_SPAN            1024            // Samples per persistence waveform
+#define PERSIST_FIFO            (1 << 16)       // Samples buffered between audio and display
+#define PERSIST_MAX_WAVES       4096            // Waveforms accumulated per frame
+#define PERSIST_DECAY           0.92f           // Histogram decay per frame
+#define SPECTRO_FFT             2048            // Spectrogram FFT size
+#define SPECTRO_HOP             512             // Samples between spectrogram columns
+#define SPECTRO_COLUMNS         512             // Spectrogram history width
+#define SPECTRO_ROWS            256             // Spectrogram frequency bins (log spaced)
+#define TRACE_SPREAD            3.f             // Default trace offsets, +-this many scene units
 
 // Width/Height of GL window
 GLsizei g_width         = INIT_WIDTH;
@@ -33,10 +50,7 @@ GLsizei g_height        = INIT_HEIGHT;
 GLsizei g_last_width    = INIT_WIDTH;
 GLsizei g_last_height   = INIT_HEIGHT;
 
-// GL global variables
-GLint g_buffer_size     = BUFFER_SIZE;
-float g_buffer[BUFFER_SIZE];
-float g_window[BUFFER_SIZE];
+// Output channels of the stream
 unsigned int g_channels = STEREO;
 
 // Threads Management
@@ -53,19 +67,190 @@ GLfloat g_light1_pos[4]     = {-2.0f, 0.0f, -4.0f, 1.0f};
 
 // Fullscreen
 GLboolean g_fullscreen = false;
-// Modelview stuff
-GLfloat g_linewidth = 2.0f;
+
+// Capture History View
+GLboolean g_history_mode = false;                   // Draw history instead of live buffer
+unsigned long long g_history_offset = 0;            // Samples back from the live edge
+unsigned long long g_history_span = 10*SAMPLE_RATE; // Samples across the screen
+std::vector<float> g_history_min;
+std::vector<float> g_history_max;
+
+// Filter Response Overlay
+FreqResponse *g_response = NULL;                    // Cached response of g_response_sos (set by main)
+GLboolean g_response_mode = false;                  // Draw the overlay
+
+// Phosphor Persistence
+Persistence *g_persist = NULL;                      // Decaying hit histogram
+RingBuffer<float> *g_scope_fifo = NULL;             // Every output sample while persistence is on
+GLboolean g_persist_mode = false;                   // Draw persistence instead of the live trace
+std::vector<float> g_persist_samples;               // Unconsumed samples from the fifo
+std::vector<int> g_persist_starts;                  // Trigger points this frame
+std::vector<unsigned int> g_persist_pixels;         // Colour-ramped histogram
+int g_persist_tail = 0;
+GLuint g_persist_texture = 0;
+
+// Spectrogram Waterfall (fed from the same fifo)
+Spectrogram *g_spectro = NULL;                      // STFT columns in a circular history
+GLboolean g_spectro_mode = false;                   // Draw the waterfall instead of the live trace
+std::vector<float> g_spectro_read;                  // Fifo drain scratch
+GLuint g_spectro_texture = 0;
+
+// Measurement Readouts
+MeasureEngine *g_measure = NULL;                    // Analysis thread (set by main)
+GLboolean g_measure_mode = true;                    // Draw the readouts
+
+// Probe Traces
+typedef struct {
+    Probe *probe;
+    bool visible;                                   // Drawn (and subscribed while the view is on)
+    float color[3];
+    float scale, offset;                            // y = offset + scale*sample, scene units
+    std::vector<float> samples;                     // Newest g_buffer_size samples
+} ProbeTrace;
+
+std::vector<ProbeTrace> g_traces;                   // One per probe (set up by main)
+GLboolean g_trace_mode = false;                     // Draw the traces instead of the live trace
+int g_trace_sel = 0;                                // Trace the arrow keys adjust
+std::vector<float> g_trace_read;                    // Probe ring drain scratch
+
+/*
+ *  Name: void allocate_persistence(int threads)
+ *  Desc: Creates the persistence histogram, its workers and the sample fifo
+ */
+void allocate_persistence(int threads) {
+    g_persist = new Persistence(PERSIST_COLS, PERSIST_ROWS, PERSIST_SPAN, threads);
+    g_scope_fifo = new RingBuffer<float>(PERSIST_FIFO);
+    g_persist_samples.resize(PERSIST_FIFO + PERSIST_SPAN);
+    g_persist_starts.resize(PERSIST_MAX_WAVES);
+    g_persist_pixels.resize(PERSIST_COLS*PERSIST_ROWS);
+}
+
+/*
+ *  Name: void allocate_spectrogram(float srate)
+ *  Desc: Creates the spectrogram history (shares the persistence fifo)
+ */
+void allocate_spectrogram(float srate) {
+    g_spectro = new Spectrogram(SPECTRO_FFT, SPECTRO_HOP, SPECTRO_COLUMNS, SPECTRO_ROWS, srate);
+    g_spectro_read.resize(PERSIST_FIFO);
+}
+
+/*
+ *  Name: void allocate_traces(ProbeSet *probes)
+ *  Desc: One trace per probe, each in its own colour, stacked top to bottom
+ */
+void allocate_traces(ProbeSet *probes) {
+    static const float palette[][3] = {
+        { 0, 0, 1 }, { 0.8f, 0, 0 }, { 0, 0.6f, 0 }, { 0.6f, 0, 0.6f }, { 0.9f, 0.5f, 0 }, { 0, 0.6f, 0.6f },
+    };
+    int n = probes->getCount();
+    g_traces.resize(n);
+    for (int i = 0; i < n; i++) {
+        ProbeTrace &t = g_traces[i];
+        t.probe = probes->get(i);
+        t.visible = true;
+        memcpy(t.color, palette[i % 6], sizeof(t.color));
+        t.scale = 1.f;
+        t.offset = (n > 1) ? TRACE_SPREAD - 2*TRACE_SPREAD*i/(n - 1) : 0.f;
+    }
+    g_trace_read.resize(PERSIST_FIFO);
+}
+
+/*
+ *  Name: void setTraceMode(bool on)
+ *  Desc: Shows the trace view; its visible probes are only fed while it's on
+ */
+void setTraceMode(bool on) {
+    if (on == (bool)g_trace_mode) return;
+    g_trace_mode = on;
+    for (unsigned int i = 0; i < g_traces.size(); i++) {
+        if (!g_traces[i].visible) continue;
+        if (on) g_traces[i].probe->subscribe();
+        else g_traces[i].probe->unsubscribe();
+        g_traces[i].samples.clear();
+    }
+}
+
+/*
+ *  Name: void showTrace(int i, bool visible)
+ *  Desc: Shows or hides one trace, subscribing its probe while it's drawn
+ */
+void showTrace(int i, bool visible) {
+    ProbeTrace &t = g_traces[i];
+    if (t.visible == visible) return;
+    t.visible = visible;
+    t.samples.clear();
+    if (!g_trace_mode) return;
+    if (visible) t.probe->subscribe();
+    else t.probe->unsubscribe();
+}
+
+/*
+ *  Name: void printTrace(int i)
+ *  Desc: One trace's settings, for the key handlers
+ */
+void printTrace(int i) {
+    ProbeTrace &t = g_traces[i];
+    printf("[main]: trace %s: %s, scale %g, offset %+.2f\n", t.probe->getName(),
+            t.visible ? "shown" : "hidden", t.scale, t.offset);
+}
+
+/*
+ *  Name: void drawProbeTraces()
+ *  Desc: Overlays every visible probe, each with its own colour, scale and
+ *        offset, zero line and name. All probes are fed by the same blocks,
+ *        so the newest samples of every trace line up.
+ */
+void drawProbeTraces() {
+    int n = g_buffer_size;
+
+    // Calculate increment x
+    GLfloat xinc = 10.f/n;
+
+    glPushMatrix();
+    for (unsigned int k = 0; k < g_traces.size(); k++) {
+        ProbeTrace &t = g_traces[k];
+        if (!t.visible) continue;
+
+        // Everything queued since the last frame, keeping the newest n samples
+        unsigned int got;
+        while ((got = t.probe->read(&g_trace_read[0], g_trace_read.size())) > 0)
+            t.samples.insert(t.samples.end(), g_trace_read.begin(), g_trace_read.begin() + got);
+        if ((int)t.samples.size() > n) t.samples.erase(t.samples.begin(), t.samples.end() - n);
+
+        // Zero line, lighter, and the name at the left edge
+        glColor3f(0.6f + 0.4f*t.color[0], 0.6f + 0.4f*t.color[1], 0.6f + 0.4f*t.color[2]);
+        glBegin(GL_LINES);
+        glVertex3f(-5, t.offset, 0.0f);
+        glVertex3f(5, t.offset, 0.0f);
+        glEnd();
+
+        glColor3fv(t.color);
+        glDisable(GL_LIGHTING);
+        glRasterPos3f(-5, t.offset + 0.15f, 0.0f);
+        for (const char *c = t.probe->getName(); *c; c++) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
+        if ((int)k == g_trace_sel) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, '*');
+        glEnable(GL_LIGHTING);
+
+        // Right-aligned, so a trace still filling up grows in from the left
+        int m = (int)t.samples.size();
+        GLfloat x = 5 - m*xinc;
+        glBegin(GL_LINE_STRIP);
+        for (int i = 0; i < m; i++) {
+            glVertex3f(x, t.offset + t.scale*t.samples[i], 0.0f);
+            x += xinc;
+        }
+        glEnd();
+    }
+    glPopMatrix();
+}
 
 /* 
  *  Name: void drawWindowedTimeDomain(float *buffer)
  *  Desc: Draws the Windowed Time Domain signal in the top of the screen
  */
 void drawWindowedTimeDomain(float *buffer) {
-    // Initialize initial x
-    GLfloat x = -5;
-
-    // Calculate increment x
-    GLfloat xinc = fabs((2*x)/g_buffer_size);
+    int n = windowedTimeDomainPoints(buffer, traceColumns(g_height));
+    int visible = zoomSamples();
 
     glPushMatrix();
     {
@@ -75,16 +260,264 @@ void drawWindowedTimeDomain(float *buffer) {
         glBegin(GL_LINE_STRIP);
 
         // Draw Windowed Time Domain
-        for (int i = 0;  i < g_buffer_size; i++)
+        for (int i = 0; i < n; i++) glVertex3f(g_view_x[i], g_view_y[i], 0.0f);
+
+        glEnd();
+
+        // Reconstructed: mark the actual samples
+        if (n != visible) {
+            int first = (g_buffer_size - visible)/2;
+            glPointSize(g_linewidth + 3);
+            glBegin(GL_POINTS);
+            for (int i = 0; i < visible; i++) glVertex3f(-5 + 10.f*i/visible, 4*buffer[first + i], 0.0f);
+            glEnd();
+        }
+    }
+    glPopMatrix();
+}
+
+/*
+ *  Name: void drawCaptureHistory()
+ *  Desc: Draws the min/max envelope of the selected capture history range
+ */
+void drawCaptureHistory() {
+    if (g_capture == NULL) return;
+
+    unsigned long long count = g_capture->getSampleCount();
+    unsigned long long end = (g_history_offset < count) ? count - g_history_offset : 0;
+    unsigned long long start = (g_history_span < end) ? end - g_history_span : 0;
+    int columns = g_width;
+
+    g_history_min.resize(columns);
+    g_history_max.resize(columns);
+    g_capture->getMinMax(start, end, columns, &g_history_min[0], &g_history_max[0]);
+
+    // Initialize initial x
+    GLfloat x = -5;
+
+    // Calculate increment x
+    GLfloat xinc = fabs((2*x)/columns);
+
+    glPushMatrix();
+    {
+        // Dark Blue Color
+        glColor3f(0, 0, 0.6);
+
+        glBegin(GL_QUAD_STRIP);
+
+        // Draw envelope, at least one line thick
+        for (int i = 0; i < columns; i++)
         {
-            glVertex3f(x, 4*buffer[i], 0.0f);
+            GLfloat hi = 4*g_history_max[i], lo = 4*g_history_min[i];
+            if (hi - lo < 0.01f) hi = lo + 0.01f;
+            glVertex3f(x, hi, 0.0f);
+            glVertex3f(x, lo, 0.0f);
             x += xinc;
         }
 
         glEnd();
+    }
+    glPopMatrix();
+}
+
+/*
+ *  Name: void drawPersistence()
+ *  Desc: Accumulates every waveform since the last frame (triggered on rising
+ *        zero crossings) into the decaying histogram and draws it as a texture
+ */
+void drawPersistence() {
+    if (g_persist == NULL) return;
+
+    // New samples after the tail kept from the last frame
+    float *s = &g_persist_samples[0];
+    int span = g_persist->getSpan();
+    int total = g_persist_tail + g_scope_fifo->read(s + g_persist_tail, g_persist_samples.size() - g_persist_tail);
+    int last = total - span;
+
+    // One waveform per trigger with a full span after it, free-running if none
+    int count = 0;
+    for (int i = 1; i <= last && count < PERSIST_MAX_WAVES; i++)
+        if (s[i - 1] < 0.f && s[i] >= 0.f) g_persist_starts[count++] = i;
+    if (count == 0 && last >= 0) g_persist_starts[count++] = last;
+
+    g_persist->decay(PERSIST_DECAY);
+    g_persist->accumulate(s, &g_persist_starts[0], count);
+
+    // Keep what can still start a waveform next frame
+    if (last > 0) {
+        memmove(s, s + last, sizeof(float)*(total - last));
+        g_persist_tail = total - last;
+    }
+    else g_persist_tail = total;
+
+    g_persist->render(&g_persist_pixels[0]);
+
+    int cols = g_persist->getColumns(), rows = g_persist->getRows();
+    if (g_persist_texture == 0) {
+        glGenTextures(1, &g_persist_texture);
+        glBindTexture(GL_TEXTURE_2D, g_persist_texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, cols, rows, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    }
+    glBindTexture(GL_TEXTURE_2D, g_persist_texture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, cols, rows, GL_RGBA, GL_UNSIGNED_BYTE, &g_persist_pixels[0]);
+
+    glPushMatrix();
+    {
+        // Unlit, so the ramp colours show as they are
+        glDisable(GL_LIGHTING);
+        glEnable(GL_TEXTURE_2D);
+        glColor3f(1.0, 1.0, 1.0);
+
+        // Same area as the live trace
+        glBegin(GL_QUADS);
+        glTexCoord2f(0, 0); glVertex3f(-5, -4, 0.0f);
+        glTexCoord2f(1, 0); glVertex3f(5, -4, 0.0f);
+        glTexCoord2f(1, 1); glVertex3f(5, 4, 0.0f);
+        glTexCoord2f(0, 1); glVertex3f(-5, 4, 0.0f);
+        glEnd();
+
+        glDisable(GL_TEXTURE_2D);
+        glEnable(GL_LIGHTING);
+    }
+    glPopMatrix();
+}
+
+/*
+ *  Name: void drawSpectrogram()
+ *  Desc: Feeds the new samples to the STFT and uploads only the columns it
+ *        added; the texture scrolls by shifting its coordinates, never redrawn
+ */
+void drawSpectrogram() {
+    if (g_spectro == NULL) return;
+
+    int n;
+    while ((n = g_scope_fifo->read(&g_spectro_read[0], g_spectro_read.size())) > 0)
+        g_spectro->push(&g_spectro_read[0], n);
+
+    int cols = g_spectro->getColumns(), rows = g_spectro->getRows();
+    int first, count = g_spectro->takeNewColumns(&first);
+    if (g_spectro_texture == 0) {
+        glGenTextures(1, &g_spectro_texture);
+        glBindTexture(GL_TEXTURE_2D, g_spectro_texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, cols, rows, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+        // Whole history once
+        first = 0;
+        count = cols;
+    }
+    glBindTexture(GL_TEXTURE_2D, g_spectro_texture);
+
+    // One column each: rows pixels, one texel wide
+    for (int k = 0; k < count; k++) {
+        int c = (first + k) % cols;
+        glTexSubImage2D(GL_TEXTURE_2D, 0, c, 0, 1, rows, GL_RGBA, GL_UNSIGNED_BYTE, g_spectro->getColumn(c));
+    }
+
+    // Oldest column at the left edge, newest at the right
+    GLfloat s0 = (GLfloat)(g_spectro->getHead() + 1)/cols, s1 = s0 + 1.f;
+
+    glPushMatrix();
+    {
+        glDisable(GL_LIGHTING);
+        glEnable(GL_TEXTURE_2D);
+        glColor3f(1.0, 1.0, 1.0);
+
+        glBegin(GL_QUADS);
+        glTexCoord2f(s0, 0); glVertex3f(-5, -4, 0.0f);
+        glTexCoord2f(s1, 0); glVertex3f(5, -4, 0.0f);
+        glTexCoord2f(s1, 1); glVertex3f(5, 4, 0.0f);
+        glTexCoord2f(s0, 1); glVertex3f(-5, 4, 0.0f);
+        glEnd();
+
+        glDisable(GL_TEXTURE_2D);
+        glEnable(GL_LIGHTING);
+    }
+    glPopMatrix();
+}
+
+/*
+ *  Name: void drawFreqResponse()
+ *  Desc: Overlays magnitude (red, +12..-60 dB) and phase (green, +-pi) of the
+ *        active filter on a log-frequency axis, recomputed only on changes
+ */
+void drawFreqResponse() {
+    if (g_response == NULL) return;
+    g_response->update(g_response_sos, g_response_sections, g_response_version);
+
+    int bins = g_response->getBins();
+    const float *mag = g_response->getMagnitude();
+    const float *phase = g_response->getPhase();
+    float logRange = logf(g_response->getMaxFrequency()/g_response->getMinFrequency());
+
+    // Calculate increment x
+    GLfloat xinc = 10.f/(bins - 1);
+
+    glPushMatrix();
+    {
+        // Grid: decades and 0 dB
+        glColor3f(0.8, 0.8, 0.8);
+        glBegin(GL_LINES);
+        for (float f = 100.f; f < g_response->getMaxFrequency(); f *= 10.f) {
+            GLfloat x = -5 + 10*logf(f/g_response->getMinFrequency())/logRange;
+            glVertex3f(x, -4, 0.0f);
+            glVertex3f(x, 4, 0.0f);
+        }
+        glVertex3f(-5, -4 + 8*60.f/72.f, 0.0f);
+        glVertex3f(5, -4 + 8*60.f/72.f, 0.0f);
+        glEnd();
+
+        // Phase
+        glColor3f(0, 0.6, 0);
+        glBegin(GL_LINE_STRIP);
+        for (int i = 0; i < bins; i++) glVertex3f(-5 + i*xinc, 4*phase[i]/M_PI, 0.0f);
+        glEnd();
+
+        // Magnitude
+        glColor3f(1.0, 0, 0);
+        glBegin(GL_LINE_STRIP);
+        for (int i = 0; i < bins; i++) {
+            float db = fmaxf(-60.f, fminf(12.f, mag[i]));
+            glVertex3f(-5 + i*xinc, -4 + 8*(db + 60.f)/72.f, 0.0f);
+        }
+        glEnd();
+    }
+    glPopMatrix();
+}
+
+/*
+ *  Name: void drawMeasurements()
+ *  Desc: Newest readouts from the analysis thread along the bottom of the window
+ */
+void drawMeasurements() {
+    if (g_measure == NULL) return;
 
+    char text[256];
+    formatMeasurements(&g_measure->read(), text, sizeof(text));
+
+    // Window pixel coordinates for the text
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glOrtho(0, g_width, 0, g_height, -1, 1);
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+    {
+        glDisable(GL_LIGHTING);
+        glColor3f(0, 0, 0);
+        glRasterPos2i(10, 10);
+        for (const char *c = text; *c; c++) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
+        glEnable(GL_LIGHTING);
     }
     glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
 }
 
 /*
@@ -129,7 +562,7 @@ void reshapeFunc(int w, int h)
 void displayFunc()
 {
     // local variables
-    float buffer[g_buffer_size];
+    float *buffer = g_display;
 
     // wait for data
     while (!g_ready) usleep(1000);
@@ -143,8 +576,18 @@ void displayFunc()
     // clear the color and depth buffers
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    // Windowed Time Domain
-    drawWindowedTimeDomain(buffer);
+    // Windowed Time Domain, Capture History, Persistence, Spectrogram or Probe Traces
+    if (g_history_mode) drawCaptureHistory();
+    else if (g_persist_mode) drawPersistence();
+    else if (g_spectro_mode) drawSpectrogram();
+    else if (g_trace_mode) drawProbeTraces();
+    else drawWindowedTimeDomain(buffer);
+
+    // Filter response on top
+    if (g_response_mode) drawFreqResponse();
+
+    // Numeric readouts
+    if (g_measure_mode) drawMeasurements();
 
     // flush gl commands
     glFlush();
@@ -158,15 +601,47 @@ void displayFunc()
  *  Desc: Callback to know when a special key is pressed
  */
 void specialKey(int key, int x, int y) { 
+    // Trace view: arrows scale and move the selected trace
+    if (g_trace_mode && !g_history_mode && !g_traces.empty()) {
+        ProbeTrace &t = g_traces[g_trace_sel];
+        switch (key) {
+            case GLUT_KEY_UP:    t.scale *= 2; break;
+            case GLUT_KEY_DOWN:  t.scale /= 2; break;
+            case GLUT_KEY_LEFT:  t.offset -= 0.25f; break;
+            case GLUT_KEY_RIGHT: t.offset += 0.25f; break;
+        }
+        printTrace(g_trace_sel);
+        return;
+    }
+
+    // Live trace: up/down zoom in on the middle of the block
+    if (!g_history_mode && !g_trace_mode && (key == GLUT_KEY_UP || key == GLUT_KEY_DOWN)) {
+        int visible = zoomSamples();
+        if (key == GLUT_KEY_UP) visible = (visible/2 > ZOOM_MIN_SAMPLES) ? visible/2 : ZOOM_MIN_SAMPLES;
+        else visible *= 2;
+        g_zoom = (visible < g_buffer_size) ? visible : 0;
+        printf("[main]: %d samples across the screen\n", zoomSamples());
+        return;
+    }
+
     // Check which (arrow) key is pressed
     switch (key) {
         case GLUT_KEY_LEFT : // Arrow key left is pressed
+            // Scroll history back
+            if (g_history_mode) g_history_offset += g_history_span/4;
             break;
         case GLUT_KEY_RIGHT :    // Arrow key right is pressed
+            // Scroll history forward, stop at the live edge
+            if (g_history_mode) 
+                g_history_offset = (g_history_offset > g_history_span/4) ? g_history_offset - g_history_span/4 : 0;
             break;
         case GLUT_KEY_UP :        // Arrow key up is pressed
+            // Zoom in
+            if (g_history_mode && g_history_span > 64) g_history_span /= 2;
             break;
         case GLUT_KEY_DOWN :    // Arrow key down is pressed
+            // Zoom out
+            if (g_history_mode) g_history_span *= 2;
             break;   
     }
 }  
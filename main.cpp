@@ -18,8 +18,8 @@
  */
 
 // Global Defines
-#define SAMPLE_RATE             44100           // Sampling Rate (44100 cycles/sec)
-#define BUFFER_SIZE             1024            // Number of frames per buffer cycle
+#define SAMPLE_RATE             44100           // Default Sampling Rate (44100 cycles/sec, --rate)
+#define BUFFER_SIZE             1024            // Default number of frames per buffer cycle (--block)
 #define NUM_IN_CHANNELS         1               // Number of inputs
 #define NUM_OUT_CHANNELS        2               // Number of outputs
 #define MONO                    1               // Mono Channel
@@ -28,23 +28,92 @@
 // Libraries for std and portaudio
 #include <stdio.h>          /* for input/output */
 #include <stdlib.h>
+#ifndef HEADLESS
 #include <portaudio.h>      /* open-source audio io */
+#endif
 #include <sndfile.h>        /* for output file */
 #include <string.h>         /* for memset */
 #include <stdbool.h>        /* for booleans */
 #include <math.h>           /* math functions */
 #include <vector>         /* variable array functions */
+#include <time.h>           /* for recording file names */
+#include <ctype.h>          /* for toupper */
 
 // Sleep Routines
 #include <unistd.h>
 
-// Open GL
+// Open GL (headless builds only get the GL-free scope view)
+#ifndef HEADLESS
 #include "gl_processor.h" 
+#else
+#include "scope_view.h"
+#endif
 
 // Audio Libraries
 #include "OscGen.h"
 #include "BiquadFilter.h"
 #include "ADSR.h"
+#include "DiskRecorder.h"
+#include "Resampler.h"
+#include "Benchmark.h"
+#include "ControlQueue.h"
+#include "RealTime.h"
+#include "TripleBuffer.h"
+#include "ProcessChain.h"
+#include "SineSweep.h"
+#include "DSPModule.h"
+#include "ABHarness.h"
+#include "Plugins/Builtin.h"
+#include "SessionLog.h"
+#include "BatchRender.h"
+#include "Probe.h"
+
+// Recorder Defines
+#define REC_RING_SIZE           (1 << 18)       // Samples buffered between audio and writer thread (~6 sec)
+#define REC_CHUNK_SIZE          (1 << 14)       // Samples per disk write
+#define CAPTURE_DIR             "capture"       // Capture history directory
+#define RS_TAPS                 64              // Device rate converter filter length (flat to 0.4 fs)
+#define MIN_BLOCK_SIZE          32              // Smallest runtime block size
+#define MAX_BLOCK_SIZE          8192            // Largest runtime block size
+#define LOW_LATENCY_LOAD        0.25f           // Callback load the low-latency probe aims under
+#define HIGH_LOAD               0.7f            // Callback load that grows the block
+#define LATENCY_RETRY_TICKS     240             // Quiet latency timer ticks (500 ms) before a failed size is retried
+#define EVENT_QUEUE_SIZE        256             // Pending control events
+#define CHAIN_FADE_FRAMES       256             // Crossfade when a new chain is swapped in
+#define RT_REPORT_WAIT_MS       1000            // Wait for the first callback's real-time setup
+#define FILTER_CUTOFF           5000.f          // Biquad cutoff (Hz)
+#define FILTER_Q                12.f            // Biquad Q
+#define RESPONSE_BINS           2048            // Filter response overlay resolution
+#define RENDER_NOTE             69              // Note held in headless renders (A4)
+#define MEASURE_RING_SIZE       (1 << 16)       // Samples buffered between audio and analysis thread
+#define SWEEP_SECONDS           8.f             // Sweep length for --sweep
+#define SWEEP_TAIL              0.5f            // Silence recorded after the sweep
+#define SWEEP_CHECK_LO          100.f           // Band compared against the designed response (Hz)
+#define SWEEP_CHECK_HI          15000.f
+#define SWEEP_MAX_MAG_ERR       0.5f            // Pass limits (dB, degrees)
+#define SWEEP_MAX_PHASE_ERR     5.f
+#define AB_TOLERANCE_DB         -80.f           // Max |A-B| re A's peak that still matches (--ab-tolerance)
+#define AB_MAX_PARAMS           16              // --ab-param options kept
+#define PROBE_RING_SIZE         (1 << 16)       // Samples buffered per probe between audio and display
+#define SESSION_RING_SIZE       (1 << 22)       // Bytes buffered between audio and session writer (~20 sec of input)
+
+// Probe points (the first four are the recorder's taps)
+enum {
+    PROBE_INPUT = DiskRecorder::TAP_INPUT,
+    PROBE_OSC = DiskRecorder::TAP_SYNTH,
+    PROBE_FILTER = DiskRecorder::TAP_FILTER,
+    PROBE_OUTPUT = DiskRecorder::TAP_OUTPUT,
+    PROBE_ENVELOPE,
+    NUM_PROBES,
+};
+
+// Parameters the GUI edits privately and publishes as one snapshot
+typedef struct {
+    float vol;              // Volume
+    bool micInputEnabled;   // Input Enable
+    bool synthEnabled;      // Synth Enable
+    bool filterEnabled;     // Filter Enable
+} paParams;
 
 // Data structure holding our variables
 typedef struct {
@@ -58,16 +127,84 @@ typedef struct {
     bool synthEnabled;      // Synth Enable
     bool filterEnabled;     // Filter Enable
 
-    OscGen *osc;            // Oscillator class
-    BiquadFilter *bFilter;  // Biquad Filter Class
+    ProcessChain *chain;    // Oscillator and filter stages, swapped at block boundaries
     ADSR *env;              // ADSR class
+
+    DiskRecorder *recorder; // Disk recorder
+    float *recBuf;          // Tapped samples for the recorder
+    float *mixBuf;          // Mono output at the device rate
+
+    Resampler *inRs;        // Device -> internal rate (NULL when equal)
+    Resampler *outRs;       // Internal -> device rate (NULL when equal)
+    RingBuffer<float> *micFifo; // Converted mic input waiting to be rendered
+    float *rsBuf;           // Converted mic block
+    float *renderBuf;       // Internal rate output before conversion
+    float *envBuf;          // Envelope gain for the current block
+    float *oscProbeBuf;     // Oscillator output for the current block (while probed)
+    float *filterProbeBuf;  // Filter output for the current block (while probed)
+    unsigned long blockSize;    // Device frames per callback
+    unsigned long maxRender;    // Largest internal block (device rate conversion)
+    double deviceRate;          // Device sample rate
+
+    std::atomic<float> load;            // Smoothed callback time / block duration
+    std::atomic<unsigned int> xruns;    // Under/overflows reported by PortAudio
+
+    ControlQueue *events;   // Timestamped control events from the GUI
+    TripleBuffer<paParams> *params; // Parameter snapshots from the GUI
+    unsigned long long sampleTime; // Internal samples rendered so far
+    bool inputUsed;         // Current block read its input (session log)
+
+    ProbeSet *probes;       // Probe points, ids PROBE_*
+    unsigned int probeMask; // Probes watched during the current block
 } paData;
 
+// GUI thread state
+typedef struct {
+    int heldKey;            // Piano key currently down (0 = none)
+    bool paramsEdited;      // Snapshot needs publishing
+    int waveform;           // Chain layout: OscGen::WAVEFORM
+    int filterType;         // Chain layout: BiquadFilter::FILTER
+    int filterStages;       // Chain layout: cascaded biquads
+    int filterPrecision;    // Chain layout: ProcessChain::PRECISION of the biquads
+    bool chainEdited;       // Chain needs rebuilding
+} guiState;
+
+// Command line options
+float g_srate = SAMPLE_RATE;        // Internal sample rate
+unsigned long g_block = BUFFER_SIZE;// Frames per callback
+bool g_low_latency = false;         // Adapt block size to the measured load
+bool g_realtime = false;            // SCHED_FIFO, locked memory
+float g_device_rate = 0;            // Forced device rate (0 = internal rate)
+float g_file_rate = 0;              // Recording file rate (0 = internal rate)
+const char *g_render_path = NULL;   // Headless frame output (--render)
+const char *g_sweep_dir = NULL;     // Sweep measurement output, "-" for none (--sweep)
+int g_render_frames = 100;          // Headless frame count (--frames)
+const char *g_ab_spec[2] = { NULL, NULL };  // Modules compared (--ab / --ab-live)
+bool g_ab_live = false;             // Compare in the live signal path instead of offline
+float g_ab_tolerance = AB_TOLERANCE_DB;
+int g_ab_params = 0;                // --ab-param id/value pairs
+int g_ab_param_id[AB_MAX_PARAMS];
+float g_ab_param_value[AB_MAX_PARAMS];
+ABHarness *g_ab = NULL;             // Live comparison, after the chain
+const char *g_session_path = NULL;  // Session log of the live run (--session)
+const char *g_replay_path = NULL;   // Session to re-run offline (--replay)
+SessionWriter *g_session = NULL;
+const char *g_batch_path = NULL;    // Golden results for the grid render (--batch)
+bool g_batch_update = false;        // Rewrite them instead of comparing
+BatchGrid g_batch_grid;             // Cases (--grid)
+float g_batch_tolerance = BATCH_LEVEL_TOL;
+float g_batch_cost = BATCH_COST_TOL;
+bool g_bench_ok = true;             // Accuracy held its bounds (--bench fastmath)
+
+#ifndef HEADLESS
 // Port Audio Struct
 PaStream *g_stream;
+#endif
 
 // Global Data Structure
 paData g_data;
+guiState g_gui;
+BiquadFilter *g_response_filter = NULL;         // GUI copy of the chain's filter design
 
 // Piano Roll Array
 std::vector<float> midi(90);
@@ -76,9 +213,36 @@ std::vector<float> midi(90);
  *  Function Protoypes
  */
 void initData(paData *pa);
+void initEngine(paData *pa);
+void initEnvelope(ADSR *env);
+bool buildChain(paData *pa, const guiState *layout, float fc, float q);
+void submitChain(paData *pa);
+void updateResponseOverlay();
+bool renderHeadless(const char *path, int frames);
+bool runSweeps(const char *dir);
+bool runReplay(const char *path);
+bool runBatch(const char *path);
+void allocateBuffers(paData *pa, unsigned long frames);
+void allocateBlockBuffers(paData *pa, unsigned long frames);
+void freeEngine(paData *pa);
+unsigned long probeBlockSize(paData *pa);
+void renderBlock(paData *data, const float *inBuf, float *outBuf, unsigned long frames);
+bool parseArgs(int argc, char **argv);
+void startRecording(paData *pa);
+void stopRecording(paData *pa);
+void applyEvent(paData *data, const ControlEvent *ev);
+void applyParams(paData *data, const paParams *p);
+void printABStats(const ABStats *st);
+#ifndef HEADLESS
+void initScope(paData *pa);
 void keyboardFunc(unsigned char, int, int);
+void keyboardUpFunc(unsigned char, int, int);
+void latencyTimer(int value);
+bool open_stream(PaStream **stream, unsigned long frames);
+void close_stream(PaStream **stream);
 void initialize_audio(PaStream **stream);
 void stop_portAudio(PaStream **stream);
+#endif
 
 /*
  *  Name: loadHelpText()
@@ -93,10 +257,26 @@ void loadHelpText() {
     printf("'f' - Toggle Full Screen\n");
     printf("'w' - Waveform Help Text\n"); 
     printf("'e' - Filter Help Text\n");
+    printf("'g' - Add Filter Stage\n");
+    printf("'b' - Remove Filter Stage\n");
+    printf("'P' - Toggle Double-Precision Filter Stages\n");
+    printf("'p' - Toggle Filter Response Overlay\n");
+    printf("'d' - Toggle Phosphor Persistence\n");
+    printf("'s' - Toggle Spectrogram Waterfall\n");
+    printf("'m' - Toggle Measurement Readouts\n");
+    printf("'a' - Switch A/B Module and Print Comparison (--ab-live)\n");
+    printf("'j' - Toggle Probe Traces (input/osc/filter/output/envelope)\n");
+    printf("'n' - Select Next Trace (arrows scale/offset it)\n");
+    printf("'y' - Show/Hide Selected Trace\n");
     printf("'=' - Increase Volume\n"); 
     printf("'-' - Decrease Volume\n"); 
     printf("'<' - Decrement Frequency\n");
     printf("'>' - Increment Frequency\n");
+    printf("'r' - Start/Stop Recording\n");
+    printf("'t' - Cycle Recording Tap (input/synth/filter/output)\n");
+    printf("'k' - Start/Stop Capture History\n");
+    printf("'l' - Toggle History View (arrows scroll/zoom)\n");
+    printf("Up/Down - Zoom Live Trace (band-limited between samples)\n");
     printf("Press caps to engage piano\n");
     printf("'q' - Quit\n");
     printf("-------------------------------------\n\n");
@@ -115,6 +295,7 @@ void wformSelectText() {
     printf("'3' - square\n");
     printf("'4' - white noise\n");
     printf("'5' - pink noise\n");
+    printf("'6' - additive (band-limited partials)\n");
     printf("'h' - Load Help Screen Text Message\n");
     printf("'q' - Quit\n");
     printf("-------------------------------------\n\n");
@@ -142,6 +323,155 @@ void filterHelpText() {
     printf("-------------------------------------\n\n");
 }
 
+/*
+ *  Name: applyEvent()
+ *  Desc: Applies one control event on the audio thread
+ */
+void applyEvent(paData *data, const ControlEvent *ev) {
+    switch (ev->type) {
+        case ControlQueue::NOTE_ON:
+            data->freq = ev->value;
+            data->chain->setFrequency(data->freq);
+            data->env->keyOn();
+            break;
+
+        case ControlQueue::NOTE_OFF:
+            data->env->keyOff();
+            break;
+    }
+}
+
+/*
+ *  Name: applyParams()
+ *  Desc: Applies a new parameter snapshot on the audio thread
+ */
+void applyParams(paData *data, const paParams *p) {
+    data->vol = p->vol;
+    data->micInputEnabled = p->micInputEnabled;
+    data->synthEnabled = p->synthEnabled;
+    data->filterEnabled = p->filterEnabled;
+}
+
+/*
+ *  Name: renderSpan()
+ *  Desc: Runs the chain over frames [start, end) of the current block
+ */
+void renderSpan(paData *data, const float *inBuf, float *outBuf, unsigned long start, unsigned long end) {
+    // Initialize variables
+    unsigned long i;
+    float sample = 0.f;
+
+    // Data initialization
+    float *recBuf   = data->recBuf;
+    int tap         = data->recorder->isRecording() ? data->recorder->getTap() : -1;
+    unsigned int enabled = (data->synthEnabled ? 1u << ProcessChain::OSC : 0) |
+                           (data->filterEnabled ? 1u << ProcessChain::FILTER : 0);
+
+    // Chain taps wanted by the recorder or a watched probe (usually none)
+    unsigned int probes = data->probeMask;
+    unsigned int taps = (probes | (tap >= 0 ? 1u << tap : 0)) & ((1u << PROBE_OSC) | (1u << PROBE_FILTER));
+    float tapOut[DiskRecorder::NUM_TAPS] = { 0 };
+
+    // Envelope for the whole span, a run per segment (events split spans, so
+    // note on/off still land on their sample)
+    float *envBuf = data->envBuf;
+    if (data->synthEnabled) data->env->process(&envBuf[start], (int)(end - start));
+    if (data->micInputEnabled) data->inputUsed = true;
+
+    // Render loop
+    for (i = start; i < end; i++) {
+        // Write input to sample
+        if (data->micInputEnabled) sample = inBuf[i];
+        if (tap == DiskRecorder::TAP_INPUT) recBuf[i] = inBuf[i];
+    
+        // Oscillator and filter stages
+        sample = data->chain->process(sample, enabled, taps, tapOut);
+        if (taps != 0) {
+            if (tap == DiskRecorder::TAP_SYNTH || tap == DiskRecorder::TAP_FILTER) recBuf[i] = tapOut[tap];
+            if (probes & (1u << PROBE_OSC)) data->oscProbeBuf[i] = tapOut[PROBE_OSC];
+            if (probes & (1u << PROBE_FILTER)) data->filterProbeBuf[i] = tapOut[PROBE_FILTER];
+        }
+
+        // ADSR Envelope
+        if (data->synthEnabled) sample *= envBuf[i];
+
+        // Write sample to output
+        outBuf[i] = sample * data->vol;
+        if (tap == DiskRecorder::TAP_OUTPUT) recBuf[i] = outBuf[i];
+    }
+
+    // Envelope probe reads unity while the envelope isn't applied
+    if ((probes & (1u << PROBE_ENVELOPE)) && !data->synthEnabled)
+        for (i = start; i < end; i++) envBuf[i] = 1.f;
+}
+
+/*
+ *  Name: renderBlock()
+ *  Desc: Renders one mono block at the internal sample rate, splitting it
+ *        wherever a control event lands so changes happen on the exact sample
+ */
+void renderBlock(paData *data, const float *inBuf, float *outBuf, unsigned long frames) {
+    RTScope rt;
+    unsigned long long t0 = data->sampleTime;
+    unsigned long long next;
+    unsigned long done = 0;
+    ControlEvent ev;
+    bool changed;
+
+    // Newest parameter snapshot, one atomic load when nothing changed
+    const paParams &params = data->params->read(&changed);
+    data->probeMask = data->probes->getActive();
+    if (changed) {
+        applyParams(data, &params);
+        if (g_session != NULL) g_session->logState(t0, &params, sizeof(params));
+    }
+
+    // Swap in a rebuilt chain, if one was submitted
+    if (data->chain->beginBlock() && g_session != NULL) g_session->logChain(t0, data->chain->getTag());
+
+    data->inputUsed = false;
+    while (done < frames) {
+        // Everything due at this sample (or late) applies now
+        while (data->events->pop(&ev, t0 + done + 1)) {
+            applyEvent(data, &ev);
+            if (g_session != NULL) g_session->logEvent(&ev);
+        }
+
+        // Render up to the next event or the end of the block
+        unsigned long end = frames;
+        if (data->events->peekTime(&next) && next < t0 + frames) end = next - t0;
+        renderSpan(data, inBuf, outBuf, done, end);
+        done = end;
+    }
+
+    // Session log: the block's input (if it was heard) and a hash of its output
+    if (g_session != NULL) g_session->logBlock(t0, data->inputUsed ? inBuf : NULL, outBuf, frames);
+
+    // Live A/B: both modules on the block, the monitored one is heard
+    if (g_ab != NULL) {
+        g_ab->process(outBuf, outBuf, (int)frames);
+        if (data->recorder->isRecording() && data->recorder->getTap() == DiskRecorder::TAP_OUTPUT)
+            memcpy(data->recBuf, outBuf, sizeof(float)*frames);
+    }
+
+    // Watched probes get the block
+    if (data->probeMask != 0) {
+        const float *probed[NUM_PROBES] = { inBuf, data->oscProbeBuf, data->filterProbeBuf, outBuf, data->envBuf };
+        for (int p = 0; p < NUM_PROBES; p++)
+            if (data->probeMask & (1u << p)) data->probes->get(p)->push(probed[p], frames);
+    }
+
+    data->sampleTime += frames;
+    data->events->publishClock(data->sampleTime, frames);
+
+    // Hand tapped block to the recorder
+    if (data->recorder->isRecording()) data->recorder->pushBlock(data->recBuf, frames);
+
+    // Append output to the capture history (live runs only)
+    if (g_capture != NULL && g_capture->isCapturing()) g_capture->pushBlock(outBuf, frames);
+}
+
+#ifndef HEADLESS
 /*
  *  Name: paCallback()
  *  Desc: callback from PortAudio
@@ -149,77 +479,433 @@ void filterHelpText() {
 static int paCallback(const void *inputBuffer, void *outputBuffer, 
         unsigned long framesPerBuffer, const PaStreamCallbackTimeInfo *timeInfo, 
         PaStreamCallbackFlags statusFlags, void *userData) {
+    // Real-time setup on first entry, RT_DEBUG traps from here on
+    enterRealtimeThread(g_realtime);
+    RTScope rt;
+
     // Initialize variables
-    int i;
-    float sample;
+    unsigned long i;
+    double start = benchNow();
 
     // Data initialization
     float *inBuf    = (float *)inputBuffer;
     float *outBuf   = (float *)outputBuffer;
     paData *data    = (paData *)userData;
+    float *mono     = data->mixBuf;
 
-    // Allocate buffer
-    memset(outBuf, 0, sizeof(float)*framesPerBuffer);
-    data->osc->setFrequency(data->freq);
+    // Analysis input at the internal rate the readouts and spectrogram assume
+    const float *analyzed = mono;
+    unsigned long analyzedFrames = framesPerBuffer;
 
-    // Callback loop
-    for (i = 0; i < framesPerBuffer; i++) {
-        // Write input to sample
-        if (data->micInputEnabled) sample = inBuf[i];
-    
-        // Generate the oscillator
-        if (data->synthEnabled) sample = data->osc->generateSample();
+    if (statusFlags & (paOutputUnderflow | paInputOverflow))
+        data->xruns.fetch_add(1, std::memory_order_relaxed);
 
-        // Filter Waveform
-        if (data->filterEnabled) sample = data->bFilter->processBiquad(sample);
-        
-        // ADSR Envelope
-        //TODO: fix this
-        // if (data->synthEnabled) sample *= data->env->processEnvelope();
+    if (data->outRs == NULL) {
+        renderBlock(data, inBuf, mono, framesPerBuffer);
+    }
+    else {
+        // Device runs at another rate: convert the mic in, then render exactly
+        // what the output converter needs for this device block
+        int used;
+        int n = data->inRs->process(inBuf, framesPerBuffer, data->rsBuf, data->maxRender, &used);
+        data->micFifo->write(data->rsBuf, n);
+        if (used < (int)framesPerBuffer) data->xruns.fetch_add(1, std::memory_order_relaxed);
+
+        int need = data->outRs->inputRequired(framesPerBuffer);
+        if (need > (int)data->maxRender) need = data->maxRender;
+        int got = data->micFifo->read(data->rsBuf, need);
+        memset(data->rsBuf + got, 0, sizeof(float)*(need - got));
+
+        renderBlock(data, data->rsBuf, data->renderBuf, need);
+        data->outRs->process(data->renderBuf, need, mono, framesPerBuffer);
+        analyzed = data->renderBuf;
+        analyzedFrames = need;
+    }
 
-        // Write sample to output
-        outBuf[2*i] = sample  * data->vol;
-        outBuf[2*i+1] = sample * data->vol;
+    // Write block to output and GL buffer
+    for (i = 0; i < framesPerBuffer; i++) {
+        outBuf[2*i] = mono[i];
+        outBuf[2*i+1] = mono[i];
 
-        // Write to GL buffer
         // if (!data->osc->isWrapped()) {
-            g_buffer[2*i] = sample * data->vol;
-            g_buffer[2*i+1] = sample * data->vol;
+            g_buffer[i] = mono[i];
         // }
     }
+
+    // Readouts
+    g_measure->pushBlock(analyzed, analyzedFrames);
+
+    // Every sample to the persistence/spectrogram display, dropped if it falls behind
+    if (g_persist_mode || g_spectro_mode) g_scope_fifo->write(analyzed, analyzedFrames);
+
     // Set flag
     g_ready = true;
 
+    // Smoothed load for the low-latency mode
+    float load = (float)((benchNow() - start) * data->deviceRate / framesPerBuffer);
+    data->load.store(0.9f*data->load.load(std::memory_order_relaxed) + 0.1f*load, std::memory_order_relaxed);
+
     return paContinue;
 }
+#endif
 
 /*
- *  Description: Initializes custom data
+ *  Description: Initializes custom data: the engine, then the GUI's chain
+ *               layout, submitted for the first block (no display or device)
  */
 void initData(paData *pa) {
+    initEngine(pa);
+
+    g_gui.heldKey = 0;
+    g_gui.paramsEdited = false;
+
+    // Initial chain, picked up by the first block
+    g_gui.waveform = OscGen::SIN;
+    g_gui.filterType = BiquadFilter::SO_LPF_BUTTERS;
+    g_gui.filterStages = 1;
+    g_gui.filterPrecision = ProcessChain::SINGLE;
+    g_gui.chainEdited = false;
+    g_response_filter = new BiquadFilter(g_srate);
+    submitChain(pa);
+}
+
+/*
+ *  Name: initEngine(paData *pa)
+ *  Desc: The chain, envelope, recorder, queues and probes renderBlock needs,
+ *        no globals touched (batch workers each make one)
+ */
+void initEngine(paData *pa) {
     pa->freq = 0.f;
     pa->oct = 4;
     pa->micInputEnabled = false;
     pa->synthEnabled = true;
     pa->filterEnabled = true;
 
-    pa->osc = new OscGen(SAMPLE_RATE);
-    pa->osc->setFrequency(pa->freq);
-    pa->osc->setWaveform(OscGen::SIN);
-    
-    pa->bFilter = new BiquadFilter(SAMPLE_RATE);
-    pa->bFilter->setCutoffFrequency(5000.f);
-    pa->bFilter->setQ(12.f);
-    pa->bFilter->setFilterType(BiquadFilter::SO_LPF_BUTTERS);
-
-    pa->env = new ADSR(SAMPLE_RATE);
-    pa->env->setValue(0);
-    pa->env->setAttackTime(0.01);
-    pa->env->setSustain(1);
-    pa->env->setDecayTime(0.1);
-    pa->env->setReleaseTime(0.01);
+    pa->chain = new ProcessChain(g_srate, CHAIN_FADE_FRAMES);
+    pa->chain->setFrequency(pa->freq);
+
+    pa->env = new ADSR(g_srate);
+    initEnvelope(pa->env);
 
     pa->vol = 0.5f;
+
+    pa->outfile = NULL;
+    pa->sf_info.samplerate = (int)g_srate;
+    pa->sf_info.channels = MONO;
+    pa->sf_info.format = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+
+    pa->recorder = new DiskRecorder(REC_RING_SIZE, REC_CHUNK_SIZE);
+    if (g_file_rate > 0) {
+        pa->sf_info.samplerate = (int)g_file_rate;
+        pa->recorder->setFileRate(g_srate, g_file_rate);
+    }
+
+    // Probe points in PROBE_* order, one trace each
+    pa->probes = new ProbeSet();
+    pa->probes->add("input", PROBE_RING_SIZE);
+    pa->probes->add("osc", PROBE_RING_SIZE);
+    pa->probes->add("filter", PROBE_RING_SIZE);
+    pa->probes->add("output", PROBE_RING_SIZE);
+    pa->probes->add("envelope", PROBE_RING_SIZE);
+    pa->probeMask = 0;
+
+    // Block buffers and rate converters are created at stream open
+    pa->recBuf = NULL;
+    pa->mixBuf = NULL;
+    pa->inRs = NULL;
+    pa->outRs = NULL;
+    pa->micFifo = NULL;
+    pa->rsBuf = NULL;
+    pa->renderBuf = NULL;
+    pa->envBuf = NULL;
+    pa->oscProbeBuf = NULL;
+    pa->filterProbeBuf = NULL;
+    pa->blockSize = 0;
+    pa->maxRender = 0;
+    pa->deviceRate = g_srate;
+    pa->load = 0.f;
+    pa->xruns = 0;
+
+    pa->events = new ControlQueue(EVENT_QUEUE_SIZE, g_srate);
+    pa->sampleTime = 0;
+    pa->inputUsed = false;
+
+    paParams init;
+    init.vol = pa->vol;
+    init.micInputEnabled = pa->micInputEnabled;
+    init.synthEnabled = pa->synthEnabled;
+    init.filterEnabled = pa->filterEnabled;
+    pa->params = new TripleBuffer<paParams>(init);
+}
+
+/*
+ *  Name: initEnvelope(ADSR *env)
+ *  Desc: Envelope settings, at rest
+ */
+void initEnvelope(ADSR *env) {
+    env->setValue(0);
+    env->setAttackTime(0.01);
+    env->setSustain(1);
+    env->setDecayTime(0.1);
+    env->setReleaseTime(0.01);
+    env->setCurve(ADSR::EXPONENTIAL);
+}
+
+/*
+ *  Name: allocateBuffers(paData *pa, unsigned long frames)
+ *  Desc: Sizes every per-block buffer for a new block size (stream closed)
+ */
+void allocateBuffers(paData *pa, unsigned long frames) {
+    allocateBlockBuffers(pa, frames);
+    allocate_scope_buffers(frames);
+}
+
+/*
+ *  Name: allocateBlockBuffers(paData *pa, unsigned long frames)
+ *  Desc: The engine's per-block buffers, no display ones
+ */
+void allocateBlockBuffers(paData *pa, unsigned long frames) {
+    delete [] pa->recBuf;
+    delete [] pa->mixBuf;
+    delete [] pa->rsBuf;
+    delete [] pa->renderBuf;
+    delete [] pa->envBuf;
+    delete [] pa->oscProbeBuf;
+    delete [] pa->filterProbeBuf;
+    delete pa->micFifo;
+
+    // Room for a device rate down to a quarter of ours, plus converter history
+    pa->blockSize = frames;
+    pa->maxRender = 4*frames + 4*RS_TAPS;
+
+    pa->recBuf = new float[pa->maxRender];
+    pa->mixBuf = new float[frames];
+    pa->rsBuf = new float[pa->maxRender];
+    pa->renderBuf = new float[pa->maxRender];
+    pa->envBuf = new float[pa->maxRender];
+    pa->oscProbeBuf = new float[pa->maxRender];
+    pa->filterProbeBuf = new float[pa->maxRender];
+    pa->micFifo = new RingBuffer<float>(2*pa->maxRender);
+    memset(pa->recBuf, 0, sizeof(float)*pa->maxRender);
+    memset(pa->mixBuf, 0, sizeof(float)*frames);
+    memset(pa->rsBuf, 0, sizeof(float)*pa->maxRender);
+    memset(pa->renderBuf, 0, sizeof(float)*pa->maxRender);
+    memset(pa->envBuf, 0, sizeof(float)*pa->maxRender);
+    memset(pa->oscProbeBuf, 0, sizeof(float)*pa->maxRender);
+    memset(pa->filterProbeBuf, 0, sizeof(float)*pa->maxRender);
+}
+
+/*
+ *  Name: freeEngine(paData *pa)
+ *  Desc: Everything initEngine and allocateBlockBuffers made
+ */
+void freeEngine(paData *pa) {
+    delete pa->chain;
+    delete pa->env;
+    delete pa->recorder;
+    delete pa->probes;
+    delete pa->events;
+    delete pa->params;
+    delete [] pa->recBuf;
+    delete [] pa->mixBuf;
+    delete [] pa->rsBuf;
+    delete [] pa->renderBuf;
+    delete [] pa->envBuf;
+    delete [] pa->oscProbeBuf;
+    delete [] pa->filterProbeBuf;
+    delete pa->micFifo;
+}
+
+/*
+ *  Name: probeBlockSize(paData *pa)
+ *  Desc: Renders the current patch offline at growing block sizes and returns
+ *        the smallest one whose load stays under LOW_LATENCY_LOAD
+ */
+unsigned long probeBlockSize(paData *pa) {
+    unsigned long best = g_block;
+    allocateBuffers(pa, g_block);
+
+    // Rendered like the audio thread would (and as a session replays it)
+    enableFlushToZero();
+    memset(pa->rsBuf, 0, sizeof(float)*pa->maxRender);
+
+    for (unsigned long frames = MIN_BLOCK_SIZE; frames < g_block; frames *= 2) {
+        // Half a second of audio per candidate
+        int blocks = (int)(0.5f*g_srate / frames);
+        double t0 = benchNow();
+        for (int b = 0; b < blocks; b++) renderBlock(pa, pa->rsBuf, pa->renderBuf, frames);
+        double load = (benchNow() - t0) * g_srate / (blocks*frames);
+
+        printf("[main]: probe %4lu frames: load %.3f\n", frames, load);
+        if (load < LOW_LATENCY_LOAD) {
+            best = frames;
+            break;
+        }
+    }
+
+    // The probe must not shift the event clock or leave state behind: the
+    // session log opens after it and replays from an engine at rest
+    pa->chain->restart();
+    initEnvelope(pa->env);
+    pa->sampleTime = 0;
+    pa->events->publishClock(0, best);
+    return best;
+}
+
+/*
+ *  Name: editChain()
+ *  Desc: GUI's chain layout, rebuilt at the end of the key event
+ */
+guiState &editChain() {
+    g_gui.chainEdited = true;
+    return g_gui;
+}
+
+/*
+ *  Name: editParams()
+ *  Desc: GUI's private parameter copy, published at the end of the key event
+ */
+paParams &editParams() {
+    g_gui.paramsEdited = true;
+    return g_data.params->edit();
+}
+
+/*
+ *  Name: chainTag(const guiState *gui) / setChainTag(guiState *gui, unsigned int tag)
+ *  Desc: Chain layout packed into the chain's tag, and back (session log)
+ */
+unsigned int chainTag(const guiState *gui) {
+    return (unsigned int)gui->waveform | (unsigned int)gui->filterType << 8 | (unsigned int)gui->filterStages << 16 |
+           (unsigned int)gui->filterPrecision << 24;
+}
+
+void setChainTag(guiState *gui, unsigned int tag) {
+    gui->waveform = tag & 0xff;
+    gui->filterType = (tag >> 8) & 0xff;
+    gui->filterStages = (tag >> 16) & 0xff;
+    gui->filterPrecision = tag >> 24;       // 0 (SINGLE) in sessions logged before it existed
+}
+
+/*
+ *  Name: buildChain(paData *pa, const guiState *layout, float fc, float q)
+ *  Desc: Builds the chain a layout describes from the node pool and hands it
+ *        to the audio thread, false (change dropped) when the pool is empty
+ */
+bool buildChain(paData *pa, const guiState *layout, float fc, float q) {
+    Chain *c = pa->chain->create();
+    if (c == NULL) {
+        printf("[main]: chain pool exhausted, change dropped\n");
+        return false;
+    }
+
+    c->tag = chainTag(layout);
+    bool ok = pa->chain->addOsc(c, layout->waveform, DiskRecorder::TAP_SYNTH);
+    for (int i = 0; ok && i < layout->filterStages; i++)
+        ok = pa->chain->addFilter(c, layout->filterType, fc, q, DiskRecorder::TAP_FILTER, layout->filterPrecision);
+
+    if (!ok) {
+        printf("[main]: chain pool exhausted, change dropped\n");
+        pa->chain->discard(c);
+        return false;
+    }
+    pa->chain->submit(c);
+    return true;
+}
+
+/*
+ *  Name: submitChain(paData *pa)
+ *  Desc: Builds the chain described by g_gui, which the audio thread
+ *        crossfades to at the next block
+ */
+void submitChain(paData *pa) {
+    if (!buildChain(pa, &g_gui, FILTER_CUTOFF, FILTER_Q)) return;
+
+    // Same design on the GUI side for the response overlay
+    g_response_filter->setCutoffFrequency(FILTER_CUTOFF);
+    g_response_filter->setQ(FILTER_Q);
+    g_response_filter->setFilterType(g_gui.filterType);
+    updateResponseOverlay();
+}
+
+/*
+ *  Name: updateResponseOverlay()
+ *  Desc: Hands the active cascade to the overlay, whose cache is keyed on the
+ *        filter's coefficient version and the number of enabled stages
+ */
+void updateResponseOverlay() {
+    int n = g_data.params->edit().filterEnabled ? g_gui.filterStages : 0;
+    SOSSection s;
+    g_response_filter->getCoefficients(&s);
+    for (int i = 0; i < n; i++) g_response_sos[i] = s;
+    g_response_sections = n;
+    g_response_version = g_response_filter->getVersion()*(2*CHAIN_MAX_NODES) + n;
+}
+
+#ifndef HEADLESS
+/*
+ *  Name: sendNote(unsigned char key, int note)
+ *  Desc: Queues a note on for a piano key
+ */
+void sendNote(unsigned char key, int note) {
+    g_gui.heldKey = key;
+    if (!g_data.events->push(ControlQueue::NOTE_ON, 0, midi[note]))
+        printf("[main]: control queue full\n");
+}
+
+/*
+ *  Name: startRecording(paData *pa)
+ *  Desc: Opens a timestamped wav file and hands it to the recorder
+ */
+void startRecording(paData *pa) {
+    char path[64];
+    time_t now = time(NULL);
+    strftime(path, sizeof(path), "recording_%Y%m%d_%H%M%S.wav", localtime(&now));
+
+    pa->outfile = sf_open(path, SFM_WRITE, &pa->sf_info);
+    if (pa->outfile == NULL) {
+        printf("[main]: could not open %s: %s\n", path, sf_strerror(NULL));
+        return;
+    }
+    pa->recorder->start(pa->outfile);
+    printf("[main]: recording to %s\n", path);
+}
+
+/*
+ *  Name: stopRecording(paData *pa)
+ *  Desc: Drains the recorder, closes the file and reports ring usage
+ */
+void stopRecording(paData *pa) {
+    if (pa->outfile == NULL) return;
+
+    pa->recorder->stop();
+    sf_close(pa->outfile);
+    pa->outfile = NULL;
+
+    printf("[main]: recording stopped: %lld frames, ring high-water %u/%u, %u dropped blocks\n",
+            (long long)pa->recorder->getFramesWritten(),
+            pa->recorder->getHighWaterMark(), pa->recorder->getRingSize(),
+            pa->recorder->getDroppedBlocks());
+}
+
+/*
+ *  Name: initScope(paData *pa)
+ *  Desc: Display side of the GL scope, created only when it runs: persistence
+ *        workers, spectrogram, probe traces, readouts and the response overlay
+ */
+void initScope(paData *pa) {
+    // Persistence binning on the cores the audio thread leaves free
+    int cores = (int)std::thread::hardware_concurrency();
+    allocate_persistence(cores > 1 ? cores - 1 : 1);
+    allocate_spectrogram(g_srate);
+
+    // One trace per probe point
+    allocate_traces(pa->probes);
+
+    // Measurements, analysis thread started with the stream
+    g_measure = new MeasureEngine(g_srate, MEASURE_RING_SIZE);
+
+    // Response overlay of the cascade submitChain publishes
+    g_response = new FreqResponse(RESPONSE_BINS, g_srate);
 }
 
 /*
@@ -228,13 +914,51 @@ void initData(paData *pa) {
  */
  void initialize_audio(PaStream **stream) {
 
+    /* Initialize PortAudio */
+    Pa_Initialize();
+
+    /* Init Data */
+    initData(&g_data);
+    initScope(&g_data);
+
+    /* Capture history reopens instantly from its persisted index (live runs only) */
+    g_capture = new CaptureStore(REC_RING_SIZE, REC_CHUNK_SIZE);
+    if (!g_capture->open(CAPTURE_DIR, g_srate)) printf("[main]: capture history disabled\n");
+
+    /* Keep everything allocated from here on resident */
+    int err;
+    if (g_realtime && (err = lockMemory()) != 0) printf("[realtime]: mlockall failed (%s)\n", strerror(err));
+
+    /* Pick the block size from the measured load of the current patch */
+    if (g_low_latency) g_block = probeBlockSize(&g_data);
+
+    /* Session log from the first live block (not the probe's), so it replays
+       from a known state */
+    if (g_session_path != NULL) {
+        g_session = new SessionWriter(SESSION_RING_SIZE);
+        if (g_session->open(g_session_path, g_srate)) printf("[main]: logging session to %s\n", g_session_path);
+        else {
+            delete g_session;
+            g_session = NULL;
+        }
+    }
+
+    /* Readouts analysis thread */
+    g_measure->start();
+
+    open_stream(stream, g_block);
+}
+
+/*
+ *  Name: open_stream(PaStream **stream, unsigned long frames)
+ *  Desc: Allocates the block buffers and opens/starts the stream
+ */
+bool open_stream(PaStream **stream, unsigned long frames) {
+
     PaStreamParameters outputParameters;
     PaStreamParameters inputParameters;
     PaError err;
 
-    /* Initialize PortAudio */
-    Pa_Initialize();
-
     /* Set input stream parameters */
     inputParameters.device = Pa_GetDefaultInputDevice();
     inputParameters.channelCount = MONO;
@@ -251,32 +975,59 @@ void initData(paData *pa) {
         Pa_GetDeviceInfo( outputParameters.device )->defaultLowOutputLatency;
     outputParameters.hostApiSpecificStreamInfo = NULL;
 
-    /* Init Data */
-    initData(&g_data);
+    /* Block buffers */
+    allocateBuffers(&g_data, frames);
+
+    /* Pick the device rate, converting at the boundary if it isn't ours */
+    double deviceRate = (g_device_rate > 0) ? g_device_rate : g_srate;
+    if (Pa_IsFormatSupported(&inputParameters, &outputParameters, deviceRate) != paFormatIsSupported)
+        deviceRate = Pa_GetDeviceInfo( outputParameters.device )->defaultSampleRate;
+
+    delete g_data.inRs;
+    delete g_data.outRs;
+    g_data.inRs = NULL;
+    g_data.outRs = NULL;
+    g_data.deviceRate = deviceRate;
+    if (deviceRate != g_srate) {
+        printf("[main]: device at %.0f Hz, converting from %.0f Hz\n", deviceRate, g_srate);
+        g_data.inRs = new Resampler(deviceRate, g_srate, RS_TAPS, 256, frames);
+        g_data.outRs = new Resampler(g_srate, deviceRate, RS_TAPS, 256, g_data.maxRender);
+    }
+    g_data.load = 0.f;
 
     /* Open audio stream */
     err = Pa_OpenStream(&(*stream),
             &inputParameters,
             &outputParameters,
-            SAMPLE_RATE, g_buffer_size, paNoFlag, 
+            deviceRate, frames, paNoFlag, 
             paCallback, &g_data);
 
     if (err != paNoError) {
         printf("PortAudio error: open stream: %s\n", Pa_GetErrorText(err));
+        return false;
     }
 
     /* Start audio stream */
+    g_rt_setup.store(RT_SETUP_PENDING);
     err = Pa_StartStream( *stream );
     if (err != paNoError) {
         printf(  "PortAudio error: start stream: %s\n", Pa_GetErrorText(err));
+        return false;
     }
+
+    /* The callback's real-time setup, reported from here rather than from it */
+    if (g_realtime) reportRealtimeSetup(RT_REPORT_WAIT_MS);
+
+    printf("[main]: stream open: %lu frames at %.0f Hz (%.1f ms)\n",
+            frames, deviceRate, 1000.0*frames/deviceRate);
+    return true;
 }
 
 /*
- *  Name: stop_portAudio(PaStream **stream)
- *  Desc: Stop, close, terminate audio stream
+ *  Name: close_stream(PaStream **stream)
+ *  Desc: Stop and close the audio stream
  */
-void stop_portAudio(PaStream **stream) {
+void close_stream(PaStream **stream) {
     PaError err;
 
     /* Stop audio stream */
@@ -289,6 +1040,17 @@ void stop_portAudio(PaStream **stream) {
     if (err != paNoError) {
         printf("PortAudio error: close stream: %s\n", Pa_GetErrorText(err));
     }
+}
+
+/*
+ *  Name: stop_portAudio(PaStream **stream)
+ *  Desc: Stop, close, terminate audio stream
+ */
+void stop_portAudio(PaStream **stream) {
+    PaError err;
+
+    close_stream(stream);
+
     /* Terminate audio stream */
     err = Pa_Terminate();
     if (err != paNoError) {
@@ -296,6 +1058,45 @@ void stop_portAudio(PaStream **stream) {
     }
 }
 
+/*
+ *  Name: latencyTimer(int value)
+ *  Desc: GLUT timer for the low-latency mode: grows the block after xruns or
+ *        overload, shrinks it again after a quiet period above the last failure
+ *        (and retries the failed size after a much longer one)
+ */
+void latencyTimer(int value) {
+    static unsigned int lastXruns = 0;
+    static unsigned long failedBlock = MIN_BLOCK_SIZE/2;    // Last block size that overloaded
+    static int quiet = 0;
+
+    unsigned int xruns = g_data.xruns.load();
+    float load = g_data.load.load();
+    unsigned long frames = g_data.blockSize;
+
+    if (xruns != lastXruns || load > HIGH_LOAD) {
+        failedBlock = frames;
+        if (frames < MAX_BLOCK_SIZE) frames *= 2;
+        quiet = 0;
+    }
+    else if (load < LOW_LATENCY_LOAD/2 && ++quiet >= 20 && frames/2 >= MIN_BLOCK_SIZE) {
+        // Shrink while above the last failure; the failed size itself is
+        // retried after a long quiet spell, so one overload doesn't pin it
+        if (frames/2 > failedBlock || quiet >= LATENCY_RETRY_TICKS) {
+            frames /= 2;
+            quiet = 0;
+        }
+    }
+
+    if (frames != g_data.blockSize) {
+        printf("[main]: load %.2f, %u xruns -> %lu frames\n", load, xruns - lastXruns, frames);
+        close_stream(&g_stream);
+        open_stream(&g_stream, frames);
+    }
+    lastXruns = g_data.xruns.load();
+
+    glutTimerFunc(500, latencyTimer, 0);
+}
+
 /*
  *  Name: keyboardFunc( )
  *  Desc: key event
@@ -332,7 +1133,7 @@ void keyboardFunc(unsigned char key, int x, int y)
             break;
 
         case 'u':
-            g_data.filterEnabled = !g_data.filterEnabled;
+            editParams().filterEnabled = !editParams().filterEnabled;
             break;
 
         // Waveform Help
@@ -340,49 +1141,158 @@ void keyboardFunc(unsigned char key, int x, int y)
             wformSelectText();
             break;
 
+        // Filter stages
+        case 'g':
+            if (g_gui.filterStages < CHAIN_MAX_NODES - 1) editChain().filterStages++;
+            printf("[main]: filter stages: %d\n", g_gui.filterStages);
+            break;
+
+        case 'b':
+            if (g_gui.filterStages > 1) editChain().filterStages--;
+            printf("[main]: filter stages: %d\n", g_gui.filterStages);
+            break;
+
+        // Filter stages in double (low cutoffs, high Q)
+        case 'P':
+            editChain().filterPrecision = (g_gui.filterPrecision == ProcessChain::SINGLE) ? ProcessChain::DOUBLE : ProcessChain::SINGLE;
+            printf("[main]: filter stages in %s\n", (g_gui.filterPrecision == ProcessChain::DOUBLE) ? "double" : "float");
+            break;
+
 
         // Input on
         case 'i':
-            g_data.micInputEnabled = !g_data.micInputEnabled;
+            editParams().micInputEnabled = !editParams().micInputEnabled;
             break;
 
         // Synth
         case 'o':
-            g_data.synthEnabled = !g_data.synthEnabled;
+            editParams().synthEnabled = !editParams().synthEnabled;
+            break;
+
+        // Recording
+        case 'r':
+            if (g_data.recorder->isRecording()) stopRecording(&g_data);
+            else startRecording(&g_data);
+            break;
+
+        // Filter response overlay
+        case 'p':
+            g_response_mode = !g_response_mode;
+            printf("[main]: filter response: %s\n", g_response_mode ? "ON" : "OFF");
+            break;
+
+        // Phosphor persistence
+        case 'd':
+            g_persist_mode = !g_persist_mode;
+            g_spectro_mode = false;
+            setTraceMode(false);
+            g_persist->clear();
+            g_persist_tail = 0;
+            printf("[main]: persistence: %s\n", g_persist_mode ? "ON" : "OFF");
             break;
 
+        // A/B: switch the monitored module and print the comparison so far
+        case 'a':
+            if (g_ab == NULL) {
+                printf("[main]: no A/B comparison (--ab-live <A> <B>)\n");
+                break;
+            }
+            g_ab->setMonitor(!g_ab->getMonitor());
+            printABStats(&g_ab->read());
+            printf("[main]: now monitoring %c\n", g_ab->getMonitor() ? 'B' : 'A');
+            break;
+
+        // Measurement readouts
+        case 'm':
+            g_measure_mode = !g_measure_mode;
+            printf("[main]: measurements: %s\n", g_measure_mode ? "ON" : "OFF");
+            break;
+
+        // Spectrogram waterfall
+        case 's':
+            g_spectro_mode = !g_spectro_mode;
+            g_persist_mode = false;
+            setTraceMode(false);
+            printf("[main]: spectrogram: %s\n", g_spectro_mode ? "ON" : "OFF");
+            break;
+
+        // Probe traces: view, select, show/hide (arrows scale/offset the selected one)
+        case 'j':
+            g_persist_mode = false;
+            g_spectro_mode = false;
+            setTraceMode(!g_trace_mode);
+            printf("[main]: probe traces: %s\n", g_trace_mode ? "ON" : "OFF");
+            break;
+
+        case 'n':
+            if (g_traces.empty()) break;
+            g_trace_sel = (g_trace_sel + 1) % (int)g_traces.size();
+            printTrace(g_trace_sel);
+            break;
+
+        case 'y':
+            if (g_traces.empty()) break;
+            showTrace(g_trace_sel, !g_traces[g_trace_sel].visible);
+            printTrace(g_trace_sel);
+            break;
+
+        // Capture History
+        case 'k':
+            if (g_capture->isCapturing()) g_capture->stop();
+            else g_capture->start();
+            printf("[main]: capture history: %s (%llu samples stored)\n",
+                    g_capture->isCapturing() ? "ON" : "OFF", g_capture->getSampleCount());
+            break;
+
+        case 'l':
+            g_history_mode = !g_history_mode;
+            g_history_offset = 0;
+            printf("[main]: history view: %s\n", g_history_mode ? "ON" : "OFF");
+            break;
+
+        case 't': {
+            static const char *tapNames[] = { "input", "synth", "filter", "output" };
+            g_data.recorder->setTap((g_data.recorder->getTap() + 1) % DiskRecorder::NUM_TAPS);
+            printf("[main]: recording tap: %s\n", tapNames[g_data.recorder->getTap()]);
+            break;
+        }
+
         // Volume Controls
         case '=':
-            g_data.vol += 0.05f;
+            editParams().vol += 0.05f;
             break;
 
         case '-':
-            g_data.vol -= 0.05f;
+            editParams().vol -= 0.05f;
             break;
 
         // Waveform Controls
         case '0':
-            g_data.osc->setWaveform(OscGen::SIN);
+            editChain().waveform = OscGen::SIN;
             break;
 
         case '1':
-            g_data.osc->setWaveform(OscGen::SAW);
+            editChain().waveform = OscGen::SAW;
             break;
 
         case '2':
-            g_data.osc->setWaveform(OscGen::TRI);
+            editChain().waveform = OscGen::TRI;
             break;
 
         case '3':
-            g_data.osc->setWaveform(OscGen::SQR);
+            editChain().waveform = OscGen::SQR;
             break;
 
         case '4':
-            g_data.osc->setWaveform(OscGen::WHITE);
+            editChain().waveform = OscGen::WHITE;
             break;
 
         case '5':
-            g_data.osc->setWaveform(OscGen::PINK);
+            editChain().waveform = OscGen::PINK;
+            break;
+
+        case '6':
+            editChain().waveform = OscGen::ADDITIVE;
             break;
 
         // Change Frequencies:
@@ -397,105 +1307,728 @@ void keyboardFunc(unsigned char key, int x, int y)
 
         // piano roll
         case 'A':
-            g_data.freq = midi[24+octave];
+            sendNote(key, 24+octave);
             break;
 
         case 'W':
-            g_data.freq = midi[25+octave];
+            sendNote(key, 25+octave);
             break;
 
         case 'S':
-            g_data.freq = midi[26+octave];
+            sendNote(key, 26+octave);
             break;
 
         case 'E':
-            g_data.freq = midi[27+octave];
+            sendNote(key, 27+octave);
             break;
 
         case 'D':
-            g_data.freq = midi[28+octave];
+            sendNote(key, 28+octave);
             break;
 
         case 'F':
-            g_data.freq = midi[29+octave];
+            sendNote(key, 29+octave);
             break;
 
         case 'T':
-            g_data.freq = midi[30+octave];
+            sendNote(key, 30+octave);
             break;
 
         case 'G':
-            g_data.freq = midi[31+octave];
+            sendNote(key, 31+octave);
             break;
 
         case 'Y':
-            g_data.freq = midi[32+octave];
+            sendNote(key, 32+octave);
             break;
 
         case 'H':
-            g_data.freq = midi[33+octave];
+            sendNote(key, 33+octave);
             break;
 
         case 'U':
-            g_data.freq = midi[34+octave];
+            sendNote(key, 34+octave);
             break;
 
         case 'J':
-            g_data.freq = midi[35+octave];
+            sendNote(key, 35+octave);
             break;
 
         case 'K':
-            g_data.freq = midi[36+octave];
+            sendNote(key, 36+octave);
             break;
 
         // Filter options
         case 'Z':
-            g_data.bFilter->setFilterType(BiquadFilter::FO_LPF);
+            editChain().filterType = BiquadFilter::FO_LPF;
             break;
 
         case 'X':
-            g_data.bFilter->setFilterType(BiquadFilter::FO_HPF);
+            editChain().filterType = BiquadFilter::FO_HPF;
             break;
 
         case 'C':
-            g_data.bFilter->setFilterType(BiquadFilter::SO_LPF);
+            editChain().filterType = BiquadFilter::SO_LPF;
             break;
 
         case 'V':
-            g_data.bFilter->setFilterType(BiquadFilter::SO_HPF);
+            editChain().filterType = BiquadFilter::SO_HPF;
             break;
 
         case 'B':
-            g_data.bFilter->setFilterType(BiquadFilter::SO_BPF);
+            editChain().filterType = BiquadFilter::SO_BPF;
             break;
 
         case 'N':
-            g_data.bFilter->setFilterType(BiquadFilter::SO_BSF);
+            editChain().filterType = BiquadFilter::SO_BSF;
             break;
 
         case 'z':
-            g_data.bFilter->setFilterType(BiquadFilter::SO_LPF_BUTTERS);
+            editChain().filterType = BiquadFilter::SO_LPF_BUTTERS;
             break;
 
         case 'x':
-            g_data.bFilter->setFilterType(BiquadFilter::SO_HPF_BUTTERS);
+            editChain().filterType = BiquadFilter::SO_HPF_BUTTERS;
             break;
 
         case 'c':
-            g_data.bFilter->setFilterType(BiquadFilter::SO_BPF_BUTTERS);
+            editChain().filterType = BiquadFilter::SO_BPF_BUTTERS;
             break;
 
         case 'v':
-            g_data.bFilter->setFilterType(BiquadFilter::SO_BSF_BUTTERS);
+            editChain().filterType = BiquadFilter::SO_BSF_BUTTERS;
             break;
 
         case 'q':
             // Close Stream before exiting
             stop_portAudio(&g_stream);
+            stopRecording(&g_data);
+            if (g_session != NULL) g_session->close();
+            g_measure->stop();
+            g_capture->stop();
+            g_capture->close();
 
             exit( 0 );
             break;
     }
+
+    // One snapshot per key event, picked up at the next block
+    if (g_gui.paramsEdited) {
+        g_gui.paramsEdited = false;
+        g_data.params->publish();
+    }
+
+    // One rebuilt chain per key event, crossfaded in at the next block
+    if (g_gui.chainEdited) {
+        g_gui.chainEdited = false;
+        submitChain(&g_data);
+    }
+
+    // Filter enable also changes the overlay (cached if nothing did)
+    updateResponseOverlay();
+}
+
+/*
+ *  Name: keyboardUpFunc( )
+ *  Desc: key release event, ends the note of the held piano key
+ */
+void keyboardUpFunc(unsigned char key, int x, int y)
+{
+    // Shift may be released first, so match the key either way
+    if (g_gui.heldKey != 0 && toupper(key) == g_gui.heldKey) {
+        g_gui.heldKey = 0;
+        g_data.events->push(ControlQueue::NOTE_OFF, 0, 0.f);
+    }
+}
+#endif
+
+/*
+ *  Name: renderHeadless(const char *path, int frames)
+ *  Desc: Renders the patch offline and rasterizes one scope frame per block.
+ *        A path ending in .raw gets a raw RGBA video stream, anything else is
+ *        a printf pattern for numbered PNGs (e.g. frames/scope_%05d.png).
+ *        The checksum over all frames is for image regression checks.
+ */
+bool renderHeadless(const char *path, int frames) {
+    initData(&g_data);
+    allocateBuffers(&g_data, g_block);
+    g_data.events->pushAt(0, ControlQueue::NOTE_ON, 0, midi[RENDER_NOTE]);
+
+    Raster raster(INIT_WIDTH, INIT_HEIGHT);
+    const char *ext = strrchr(path, '.');
+    bool raw = (ext != NULL && !strcmp(ext, ".raw"));
+    FILE *video = NULL;
+    if (raw && (video = fopen(path, "wb")) == NULL) {
+        printf("[main]: could not open %s\n", path);
+        return false;
+    }
+
+    // Readouts over the whole render, measured inline (no analysis thread)
+    Measure measure(g_srate);
+    Measurements m;
+
+    bool ok = true;
+    unsigned int checksum = 2166136261u;
+    double drawTime = 0, t0 = benchNow();
+    int f;
+    for (f = 0; f < frames && ok; f++) {
+        // Silent mic input, the synth fills the block
+        renderBlock(&g_data, g_data.rsBuf, g_display, g_block);
+        measure.push(g_display, g_block);
+
+        double d0 = benchNow();
+        rasterWindowedTimeDomain(&raster, g_display);
+        drawTime += benchNow() - d0;
+        checksum = (checksum ^ raster.checksum())*16777619u;
+
+        if (raw) ok = raster.writeRaw(video);
+        else {
+            char name[512];
+            snprintf(name, sizeof(name), path, f);
+            ok = raster.writePNG(name);
+        }
+    }
+    double total = benchNow() - t0;
+    if (video != NULL) fclose(video);
+
+    printf("[main]: %d frames %dx%d, %.0f frames/s drawn, %.0f frames/s with export, checksum %08x\n",
+            f, raster.getWidth(), raster.getHeight(), f/drawTime, f/total, checksum);
+
+    char text[256];
+    measure.analyze(&m);
+    formatMeasurements(&m, text, sizeof(text));
+    printf("[main]: %s\n", text);
+    return ok;
+}
+
+/*
+ *  Name: sweepReport(SineSweep *sweep, const char *name, const float *out, const SOSSection *sos, int n, float gain, const char *dir)
+ *  Desc: Deconvolves one recorded sweep, compares it against the designed
+ *        response (gain times the cascade), prints a row and writes the impulse
+ *        and frequency response files. Returns true if within the limits.
+ */
+bool sweepReport(SineSweep *sweep, const char *name, const float *out, const SOSSection *sos, int n, float gain, const char *dir) {
+    sweep->analyze(out);
+
+    // Worst error over the checked band, phase only where there is signal to measure
+    float magErr = 0.f, phaseErr = 0.f;
+    for (int i = 0; i < 64; i++) {
+        float f = SWEEP_CHECK_LO*powf(SWEEP_CHECK_HI/SWEEP_CHECK_LO, i/63.f), mag, phase;
+        std::complex<double> h = (double)gain*IIRDesign::response(sos, n, f, g_srate);
+        float expMag = 20.f*log10f((float)std::abs(h) + 1e-10f);
+        if (expMag < -50.f) continue;
+
+        sweep->getResponse(f, &mag, &phase);
+        magErr = fmaxf(magErr, fabsf(mag - expMag));
+        if (expMag > -30.f)
+            phaseErr = fmaxf(phaseErr, fabsf(remainderf(phase - (float)std::arg(h), 2*M_PI))*180.f/M_PI);
+    }
+    bool pass = magErr < SWEEP_MAX_MAG_ERR && phaseErr < SWEEP_MAX_PHASE_ERR;
+
+    printf("%-16s %9.3f %9.2f", name, magErr, phaseErr);
+    for (int order = 2; order <= SWEEP_MAX_ORDER; order++) printf(" %7.1f", sweep->getHarmonic(order));
+    printf("   %s\n", pass ? "ok" : "FAIL");
+
+    if (strcmp(dir, "-") != 0) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s_ir.txt", dir, name);
+        FILE *f = fopen(path, "w");
+        if (f != NULL) {
+            const float *ir = sweep->getImpulse();
+            for (int i = 0; i < sweep->getImpulseLength(); i++)
+                fprintf(f, "%d %g\n", i - sweep->getImpulseStart(), ir[i]);
+            fclose(f);
+        }
+        snprintf(path, sizeof(path), "%s/%s_fr.txt", dir, name);
+        if ((f = fopen(path, "w")) != NULL) {
+            for (int i = 0; i < 256; i++) {
+                float fr = 20.f*powf(1000.f, i/255.f), mag, phase;
+                sweep->getResponse(fr, &mag, &phase);
+                fprintf(f, "%g %g %g\n", fr, mag, phase);
+            }
+            fclose(f);
+        }
+        else printf("[main]: could not write %s\n", path);
+    }
+    return pass;
+}
+
+/*
+ *  Name: runSweeps(const char *dir)
+ *  Desc: Exponential sine sweep straight through (the measurement's own floor),
+ *        through every BiquadFilter type, then through the default chain via
+ *        renderBlock (mic input path) with its filter stages in float and in
+ *        double, offline.
+ *        Impulse and frequency responses go to dir unless it is "-".
+ */
+bool runSweeps(const char *dir) {
+    static const struct { const char *name; int type; } types[] = {
+        { "fo_lpf", BiquadFilter::FO_LPF }, { "fo_hpf", BiquadFilter::FO_HPF },
+        { "so_lpf", BiquadFilter::SO_LPF }, { "so_hpf", BiquadFilter::SO_HPF },
+        { "so_bpf", BiquadFilter::SO_BPF }, { "so_bsf", BiquadFilter::SO_BSF },
+        { "so_lpf_butters", BiquadFilter::SO_LPF_BUTTERS }, { "so_hpf_butters", BiquadFilter::SO_HPF_BUTTERS },
+        { "so_bpf_butters", BiquadFilter::SO_BPF_BUTTERS }, { "so_bsf_butters", BiquadFilter::SO_BSF_BUTTERS },
+    };
+
+    SineSweep sweep(g_srate, 20.f, 20000.f, SWEEP_SECONDS, SWEEP_TAIL);
+    int length = sweep.getLength();
+    const float *in = sweep.getSignal();
+    std::vector<float> out(length + g_block);
+
+    printf("sweep 20 Hz - 20 kHz, %.1f s; errors over %.0f Hz - %.0f kHz vs the designed response\n",
+            SWEEP_SECONDS, SWEEP_CHECK_LO, SWEEP_CHECK_HI/1000.f);
+    printf("%-16s %9s %9s %7s %7s %7s %7s\n", "chain", "mag(dB)", "phase(o)", "H2", "H3", "H4", "H5");
+
+    // Identity first: whatever it reads as error or distortion is the floor
+    // the rows below sit on, not the filters
+    SOSSection unity = { 1.f, 0.f, 0.f, 0.f, 0.f };
+    bool ok = sweepReport(&sweep, "identity", in, &unity, 1, 1.f, dir);
+
+    double t0 = benchNow();
+    for (unsigned int t = 0; t < sizeof(types)/sizeof(types[0]); t++) {
+        BiquadFilter filter(g_srate);
+        filter.setCutoffFrequency(FILTER_CUTOFF);
+        filter.setQ(FILTER_Q);
+        filter.setFilterType(types[t].type);
+        for (int i = 0; i < length; i++) out[i] = filter.processBiquad(in[i]);
+
+        SOSSection s;
+        filter.getCoefficients(&s);
+        ok &= sweepReport(&sweep, types[t].name, &out[0], &s, 1, 1.f, dir);
+    }
+
+    // Default patch with the sweep on the mic input instead of the synth
+    initData(&g_data);
+    allocateBuffers(&g_data, g_block);
+    paParams &params = g_data.params->edit();
+    params.micInputEnabled = true;
+    params.synthEnabled = false;
+    params.filterEnabled = true;
+    g_data.params->publish();
+
+    // Its filter stages in float, then in double; each sweep starts cold
+    std::vector<float> block(g_block);
+    for (int p = ProcessChain::SINGLE; p <= ProcessChain::DOUBLE; p++) {
+        g_gui.filterPrecision = p;
+        submitChain(&g_data);
+        g_data.chain->restart();
+
+        for (int i = 0; i < length; i += g_block) {
+            int n = (length - i < (int)g_block) ? length - i : g_block;
+            memset(&block[0], 0, sizeof(float)*g_block);
+            memcpy(&block[0], in + i, sizeof(float)*n);
+            renderBlock(&g_data, &block[0], &out[i], g_block);
+        }
+        const char *name = (p == ProcessChain::DOUBLE) ? "chain64" : "chain";
+        ok &= sweepReport(&sweep, name, &out[0], g_response_sos, g_response_sections, g_data.vol, dir);
+    }
+
+    int sweeps = sizeof(types)/sizeof(types[0]) + 3;
+    double seconds = benchNow() - t0;
+    printf("[main]: %d sweeps, %.1fx realtime\n", sweeps, sweeps*(double)length/g_srate/seconds);
+    return ok;
+}
+
+/*
+ *  Name: runReplay(const char *path)
+ *  Desc: Re-runs a logged session offline as fast as it renders (or under a
+ *        profiler): parameter snapshots, chain swaps and events go back in
+ *        through the same queues, every block through renderBlock with the
+ *        input it had live. Fails if any block's output isn't bit-exact.
+ */
+bool runReplay(const char *path) {
+    SessionReader log;
+    if (!log.open(path)) return false;
+
+    // Same float mode as the audio thread, denormals would change the output
+    enableFlushToZero();
+
+    g_srate = log.getSampleRate();
+    initData(&g_data);
+    allocateBuffers(&g_data, MAX_BLOCK_SIZE);
+    std::vector<float> silence(g_data.maxRender, 0.f);
+
+    SessionRecord r;
+    ControlEvent ev;
+    unsigned long long blocks = 0, samples = 0, mismatches = 0, firstBad = 0, worstTime = 0;
+    unsigned long worstFrames = 0;
+    double busy = 0, worst = 0;
+    unsigned int checksum = SESSION_HASH_SEED;
+    while (log.next(&r)) {
+        switch (r.type) {
+            case SESSION_STATE:
+                if (r.size != sizeof(paParams)) break;
+                memcpy(&g_data.params->edit(), log.getPayload(), sizeof(paParams));
+                g_data.params->publish();
+                break;
+
+            case SESSION_CHAIN:
+                // Live, the reclaimer kept up with the swaps; give it the time here
+                while (g_data.chain->getSwaps() - g_data.chain->getReclaimed() > 2) usleep(1000);
+                setChainTag(&g_gui, r.arg);
+                submitChain(&g_data);
+                break;
+
+            case SESSION_EVENT:
+                memcpy(&ev, log.getPayload(), sizeof(ev));
+                g_data.events->pushAt(ev.time, ev.type, ev.param, ev.value);
+                break;
+
+            case SESSION_BLOCK:
+            case SESSION_BLOCK_INPUT: {
+                if (r.arg > g_data.maxRender) {
+                    printf("[main]: %s: block of %u frames, max %lu\n", path, r.arg, g_data.maxRender);
+                    return false;
+                }
+                const float *in = (r.type == SESSION_BLOCK_INPUT) ? (const float *)log.getPayload() : &silence[0];
+                g_data.sampleTime = r.time;
+
+                double t0 = benchNow();
+                renderBlock(&g_data, in, g_data.renderBuf, r.arg);
+                double t = benchNow() - t0;
+
+                busy += t;
+                if (t > worst) {
+                    worst = t;
+                    worstTime = r.time;
+                    worstFrames = r.arg;
+                }
+                unsigned int h = sessionHash(g_data.renderBuf, r.arg);
+                if (h != r.hash && mismatches++ == 0) firstBad = r.time;
+                checksum = (checksum ^ h)*16777619u;
+                blocks++;
+                samples += r.arg;
+                break;
+            }
+        }
+    }
+
+    if (blocks == 0) {
+        printf("[main]: %s: no blocks\n", path);
+        return false;
+    }
+    printf("[main]: %llu blocks, %.1f s of audio in %.3f s (%.0fx realtime)\n",
+            blocks, samples/g_srate, busy, samples/(g_srate*busy));
+    printf("[main]: block cost mean %.1f us, worst %.1f us at sample %llu (%.1f%% of its %.2f ms)\n",
+            1e6*busy/blocks, 1e6*worst, worstTime, 100.0*worst*g_srate/worstFrames, 1000.0*worstFrames/g_srate);
+    if (mismatches == 0) printf("[main]: output bit-exact, checksum %08x\n", checksum);
+    else printf("[main]: output DIFFERS in %llu blocks, first at sample %llu\n", mismatches, firstBad);
+    return mismatches == 0;
+}
+
+// Batch worker: its own engine, and the case its chain was built for
+typedef struct {
+    paData data;
+    BatchCase built;
+    bool hasChain;
+} batchWorker;
+
+/*
+ *  Name: batchOpen(int maxBlock)
+ *  Desc: One worker's engine, in the audio thread's float mode
+ */
+void *batchOpen(int maxBlock) {
+    enableFlushToZero();
+    batchWorker *w = new batchWorker;
+    initEngine(&w->data);
+    allocateBlockBuffers(&w->data, maxBlock);
+    w->hasChain = false;
+    return w;
+}
+
+/*
+ *  Name: batchRenderCase(void *self, const BatchCase *c, float *out, int n)
+ *  Desc: One case as a live note: its chain from the pool, then renderBlock
+ *        in c->block frames with a note on at sample 0 and a note off at
+ *        BATCH_RELEASE_AT, which split the spans as they would live
+ */
+void batchRenderCase(void *self, const BatchCase *c, float *out, int n) {
+    batchWorker *w = (batchWorker *)self;
+    paData *pa = &w->data;
+
+    // Passes of the same case reuse the chain; an empty pool waits for the reclaimer
+    if (!w->hasChain || memcmp(&w->built, c, sizeof(*c)) != 0) {
+        while (pa->chain->getFreeChains() == 0) usleep(1000);
+        guiState layout = { 0, false, c->waveform, c->filter, 1, ProcessChain::SINGLE, false };
+        w->hasChain = buildChain(pa, &layout, c->cutoff, c->q);
+        w->built = *c;
+    }
+
+    // Cold start: no crossfade from the last case, nodes and envelope at rest
+    pa->chain->restart();
+    initEnvelope(pa->env);
+    pa->sampleTime = 0;
+    pa->events->pushAt(0, ControlQueue::NOTE_ON, 0, BATCH_NOTE_HZ);
+    pa->events->pushAt((unsigned long long)(BATCH_RELEASE_AT*n), ControlQueue::NOTE_OFF, 0, 0.f);
+
+    // Silent mic input, the synth fills the block
+    for (int start = 0; start < n; start += c->block) {
+        int frames = (n - start < c->block) ? n - start : c->block;
+        renderBlock(pa, pa->rsBuf, out + start, frames);
+    }
+}
+
+/*
+ *  Name: batchClose(void *self)
+ *  Desc: Frees a worker's engine
+ */
+void batchClose(void *self) {
+    batchWorker *w = (batchWorker *)self;
+    freeEngine(&w->data);
+    delete w;
+}
+
+/*
+ *  Name: runBatch(const char *path)
+ *  Desc: Renders every case of the grid on all cores, each worker through its
+ *        own engine, and checks them against the golden results in path.
+ *        Those are only written with --batch-update; missing or unreadable
+ *        golden results are an error otherwise.
+ */
+bool runBatch(const char *path) {
+    static const BatchRenderer renderer = { batchOpen, batchRenderCase, batchClose };
+    std::vector<BatchCase> cases;
+    std::vector<BatchResult> results;
+    g_batch_grid.expand(&cases);
+    int threads = (int)std::thread::hardware_concurrency();
+    if (threads < 1) threads = 1;
+
+    std::map<std::string, BatchResult> golden;
+    if (!g_batch_update && !batchReadGolden(path, &golden)) {
+        printf("[main]: no golden results in %s (--batch-update writes them)\n", path);
+        return false;
+    }
+
+    double t0 = benchNow();
+    batchRun(cases, g_srate, threads, &renderer, &results);
+    double t = benchNow() - t0;
+
+    printf("[main]: %u cases (", (unsigned int)cases.size());
+    g_batch_grid.print();
+    printf("), %.0f s of audio x %d passes in %.2f s on %d threads\n", cases.size()*BATCH_SECONDS, BATCH_PASSES, t, threads);
+
+    if (!g_batch_update) return batchCompare(cases, results, golden, g_batch_tolerance, g_batch_cost);
+
+    if (!batchWriteGolden(path, cases, results)) {
+        printf("[main]: could not write %s\n", path);
+        return false;
+    }
+    printf("[main]: golden results written to %s\n", path);
+    return true;
+}
+
+/*
+ *  Name: openModule(const char *spec, int maxBlock)
+ *  Desc: "builtin:<name>" or a shared object path, NULL if it won't load
+ */
+DSPModule *openModule(const char *spec, int maxBlock) {
+    const DSPPlugin *builtin = builtinPlugin(spec);
+    if (builtin != NULL) return new DSPModule(builtin, NULL, g_srate, maxBlock);
+    if (!strncmp(spec, BUILTIN_PREFIX, strlen(BUILTIN_PREFIX))) {
+        printf("[main]: no built-in module '%s' (builtin:biquad, builtin:biquad64, builtin:svf, builtin:osc)\n", spec);
+        return NULL;
+    }
+    return DSPModule::open(spec, g_srate, maxBlock);
+}
+
+/*
+ *  Name: openABHarness(int maxBlock)
+ *  Desc: Loads both --ab modules and applies the --ab-param values to them
+ */
+ABHarness *openABHarness(int maxBlock) {
+    DSPModule *a = openModule(g_ab_spec[0], maxBlock);
+    DSPModule *b = (a != NULL) ? openModule(g_ab_spec[1], maxBlock) : NULL;
+    if (b == NULL) {
+        delete a;
+        return NULL;
+    }
+
+    ABHarness *ab = new ABHarness(a, b, maxBlock);
+    for (int i = 0; i < g_ab_params; i++) ab->setParam(g_ab_param_id[i], g_ab_param_value[i]);
+    printf("[main]: A = %s (%s), B = %s (%s)\n", g_ab_spec[0], a->getName(), g_ab_spec[1], b->getName());
+    return ab;
+}
+
+/*
+ *  Name: printABStats(const ABStats *st)
+ *  Desc: Cost of each module and how far apart their outputs are
+ */
+void printABStats(const ABStats *st) {
+    if (st->samples == 0) {
+        printf("[main]: A/B: no samples yet\n");
+        return;
+    }
+
+    double nsA = st->secondsA*1e9/st->samples, nsB = st->secondsB*1e9/st->samples;
+    double rmsA = sqrt(st->sumSqA/st->samples), rmsDiff = sqrt(st->sumSqDiff/st->samples);
+    double ref = (st->peakA > 0) ? st->peakA : 1.0;
+    printf("        %10s %12s\n", "ns/sample", "x realtime");
+    printf("A       %10.2f %12.0f\n", nsA, 1e9/(nsA*g_srate));
+    printf("B       %10.2f %12.0f   (%.2fx A)\n", nsB, 1e9/(nsB*g_srate), nsA/nsB);
+    printf("max |A-B| %.3g (%.1f dB re A peak), RMS %.3g (%.1f dB re A RMS), %llu samples, monitoring %c\n",
+           st->maxDiff, 20*log10(st->maxDiff/ref + 1e-30), rmsDiff, 20*log10(rmsDiff/(rmsA + 1e-30) + 1e-30),
+           st->samples, st->monitor ? 'B' : 'A');
+}
+
+/*
+ *  Name: runAB()
+ *  Desc: Offline A/B: white noise and a log sweep through both modules in
+ *        --block sized blocks, then silence after resetting both (measured on
+ *        its own). Fails if either part differs by more than the tolerance
+ *        (or a module won't load).
+ */
+bool runAB() {
+    ABHarness *ab = openABHarness((int)g_block);
+    if (ab == NULL) return false;
+
+    // 1 s noise, 2 s sweep 20 Hz - 20 kHz, 0.5 s silence (half scale)
+    int noise = (int)g_srate, sweep = 2*(int)g_srate, length = noise + sweep + (int)g_srate/2;
+    std::vector<float> in(length, 0.f), out(length);
+    unsigned int seed = 22222;
+    for (int i = 0; i < noise; i++) {
+        seed = seed * 1103515245u + 12345u;
+        in[i] = 0.5f*((seed >> 8)/8388608.f - 1.f);
+    }
+    double L = (sweep/g_srate)/log(1000.0);
+    for (int i = 0; i < sweep; i++) in[noise + i] = 0.5f*(float)sin(2*M_PI*20.0*L*(exp(i/g_srate/L) - 1.0));
+
+    // Each part from reset modules, and the silence measured on its own: how a
+    // module rings out, or clears its state on zero input (the biquad does, at
+    // the sweep's first sample too), is its own business; what is compared is
+    // the response to signal and that both then stay quiet
+    const int parts[] = { 0, noise, noise + sweep, length };
+    float diff = 0.f, quiet, ref = 1.f;
+    for (int p = 0; p < 3; p++) {
+        ab->getA()->reset();
+        ab->getB()->reset();
+        if (p == 2) {
+            const ABStats &st = ab->getStats();
+            printABStats(&st);
+            ref = (st.peakA > 0) ? st.peakA : 1.f;
+            diff = 20*log10f(st.maxDiff/ref + 1e-30f);
+            ab->clear();
+        }
+        for (int i = parts[p]; i < parts[p + 1]; i += (int)g_block) {
+            int n = (parts[p + 1] - i < (int)g_block) ? parts[p + 1] - i : (int)g_block;
+            ab->process(&in[i], &out[i], n);
+        }
+    }
+    quiet = 20*log10f(ab->getStats().maxDiff/ref + 1e-30f);
+    if (ab->getStats().maxDiff > 0) printf("silence: max |A-B| %.1f dB re A peak\n", quiet);
+    else printf("silence: identical\n");
+
+    bool match = diff <= g_ab_tolerance && quiet <= g_ab_tolerance;
+    printf("[main]: outputs %s (tolerance %.0f dB)\n", match ? "match" : "DIFFER", g_ab_tolerance);
+    delete ab;
+    return match;
+}
+
+/*
+ *  Name: parseABParam(const char *arg)
+ *  Desc: name=value for --ab-param (freq, cutoff, q, type)
+ */
+bool parseABParam(const char *arg) {
+    static const char *names[] = { "freq", "cutoff", "q", "type" };
+    static const int ids[] = { DSP_PARAM_FREQUENCY, DSP_PARAM_CUTOFF, DSP_PARAM_Q, DSP_PARAM_TYPE };
+    const char *eq = strchr(arg, '=');
+    if (eq == NULL || g_ab_params >= AB_MAX_PARAMS) return false;
+
+    for (unsigned int k = 0; k < sizeof(ids)/sizeof(ids[0]); k++) {
+        if (strlen(names[k]) == (size_t)(eq - arg) && !strncmp(arg, names[k], eq - arg)) {
+            g_ab_param_id[g_ab_params] = ids[k];
+            g_ab_param_value[g_ab_params++] = atof(eq + 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ *  Name: parseArgs(int argc, char **argv)
+ *  Desc: Handles our command line options, returns false when the app should exit
+ */
+bool parseArgs(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--device-rate") && i + 1 < argc) {
+            g_device_rate = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--file-rate") && i + 1 < argc) {
+            g_file_rate = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--rate") && i + 1 < argc) {
+            g_srate = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--block") && i + 1 < argc) {
+            g_block = strtoul(argv[++i], NULL, 10);
+            if (g_block < MIN_BLOCK_SIZE) g_block = MIN_BLOCK_SIZE;
+            if (g_block > MAX_BLOCK_SIZE) g_block = MAX_BLOCK_SIZE;
+        }
+        else if (!strcmp(argv[i], "--low-latency")) {
+            g_low_latency = true;
+        }
+        else if (!strcmp(argv[i], "--realtime")) {
+            g_realtime = true;
+        }
+        else if (!strcmp(argv[i], "--render") && i + 1 < argc) {
+            g_render_path = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--frames") && i + 1 < argc) {
+            g_render_frames = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--zoom") && i + 1 < argc) {
+            g_zoom = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--session") && i + 1 < argc) {
+            g_session_path = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--replay") && i + 1 < argc) {
+            g_replay_path = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--batch") && i + 1 < argc) {
+            g_batch_path = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--batch-update")) {
+            g_batch_update = true;
+        }
+        else if (!strcmp(argv[i], "--grid") && i + 1 < argc) {
+            if (!g_batch_grid.set(argv[++i])) printf("[main]: ignoring --grid %s (wave|filter|cutoff|q|block=v1,v2,...)\n", argv[i]);
+        }
+        else if (!strcmp(argv[i], "--batch-tolerance") && i + 1 < argc) {
+            g_batch_tolerance = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--batch-cost") && i + 1 < argc) {
+            g_batch_cost = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--sweep") && i + 1 < argc) {
+            g_sweep_dir = argv[++i];
+        }
+        else if ((!strcmp(argv[i], "--ab") || !strcmp(argv[i], "--ab-live")) && i + 2 < argc) {
+            g_ab_live = !strcmp(argv[i], "--ab-live");
+            g_ab_spec[0] = argv[++i];
+            g_ab_spec[1] = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--ab-param") && i + 1 < argc) {
+            if (!parseABParam(argv[++i])) printf("[main]: ignoring --ab-param %s (freq|cutoff|q|type=value)\n", argv[i]);
+        }
+        else if (!strcmp(argv[i], "--ab-tolerance") && i + 1 < argc) {
+            g_ab_tolerance = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--bench") && i + 1 < argc) {
+            const char *name = argv[++i];
+            if (!strcmp(name, "resampler")) benchResampler();
+            else if (!strcmp(name, "iir")) benchIIR();
+            else if (!strcmp(name, "persistence")) benchPersistence();
+            else if (!strcmp(name, "fastmath")) g_bench_ok = benchFastMath();
+            else if (!strcmp(name, "adsr")) benchADSR();
+            else if (!strcmp(name, "additive")) benchAdditive();
+            else if (!strcmp(name, "display")) benchDisplay();
+            else if (!strcmp(name, "precision")) benchPrecision();
+            else if (!strcmp(name, "svf")) benchSVF();
+            else printf("[main]: unknown benchmark '%s'\n", name);
+            return false;
+        }
+    }
+    return true;
 }
 
 /*
@@ -503,22 +2036,53 @@ void keyboardFunc(unsigned char key, int x, int y)
  */
 int main(int argc, char **argv) {
 
+    // Command line options and offline modes
+    if (!parseArgs(argc, argv)) return g_bench_ok ? EXIT_SUCCESS : EXIT_FAILURE;
+
     // Create MIDI values
     midi[0] = 0;
     for (int i = 1; i < 90; i++) {
-        float freq = powf(powf(2.f, 1.f/12.f), i-69)*440.f;
+        float freq = fastExp2<FM_PRECISE>((i - 69)/12.f)*440.f;
         midi[i] = freq;
     }
 
+    // Headless frames, no audio device or window
+    if (g_render_path != NULL) return renderHeadless(g_render_path, g_render_frames) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    // Logged session, re-rendered offline
+    if (g_replay_path != NULL) return runReplay(g_replay_path) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    // Parameter grid against golden results
+    if (g_batch_path != NULL) return runBatch(g_batch_path) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    // Sweep measurements of every filter type and the default chain
+    if (g_sweep_dir != NULL) return runSweeps(g_sweep_dir) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    // Offline A/B comparison of two modules
+    if (g_ab_spec[0] != NULL && !g_ab_live) return runAB() ? EXIT_SUCCESS : EXIT_FAILURE;
+
+#ifdef HEADLESS
+    printf("[main]: headless build: --render, --replay, --batch, --sweep, --ab or --bench\n");
+    return EXIT_FAILURE;
+#else
+    // Live A/B: both modules after the chain, sized for the largest render block
+    if (g_ab_live && (g_ab = openABHarness(4*MAX_BLOCK_SIZE + 4*RS_TAPS)) == NULL) return EXIT_FAILURE;
+
     // Initialize GLUT
     initialize_glut(argc, argv);
 
     // set the keyboard function - called on keyboard events
     glutKeyboardFunc( keyboardFunc );
+    // note off on release, without auto-repeat retriggering notes
+    glutKeyboardUpFunc( keyboardUpFunc );
+    glutIgnoreKeyRepeat( 1 );
     
     // Initialize PortAudio
     initialize_audio(&g_stream);
 
+    // Low-latency mode keeps adjusting the block size
+    if (g_low_latency) glutTimerFunc(500, latencyTimer, 0);
+
     // print help
     loadHelpText();
 
@@ -526,4 +2090,5 @@ int main(int argc, char **argv) {
     glutMainLoop();
 
     return EXIT_SUCCESS;
+#endif
 }
@@ -0,0 +1,178 @@
+/*
+ * ==================================================================================
+ *
+ *      Filename:   scope_view.h
+ *
+ *   Description:   Display state shared by the GL scope and headless renders
+ *                  Scope buffers, the live trace geometry (zoom, band-limited
+ *                  reconstruction), its software rasterization and the active
+ *                  filter cascade, with no OpenGL or GLUT dependency, so the
+ *                  offline modes build without a display stack.
+ *
+ *       Version:   1.0
+ *       Created:   10/18/2026
+ *
+ *        Author:   Ryan Foo (ryanfoo@nyu.edu)
+ *       Website:   https://github.com/ryanfoo
+ *
+ * ==================================================================================
+ */
+
+#ifndef SCOPE_VIEW_H
+#define SCOPE_VIEW_H
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include "CaptureStore.h"
+#include "SOSCascade.h"
+#include "Raster.h"
+#include "Measure.h"
+#include "SincDisplay.h"
+
+// View Definitions
+#define INIT_WIDTH              900             // GL View Width
+#define INIT_HEIGHT             700             // GL View Height
+#define ZOOM_MIN_SAMPLES        8               // Narrowest live trace zoom
+#define SINC_MIN_SPACING        2               // Pixels per sample before the trace is reconstructed
+
+// Scope buffers (sized at stream open)
+int g_buffer_size       = BUFFER_SIZE;
+float *g_buffer         = NULL;
+float *g_window         = NULL;
+float *g_display        = NULL;
+
+// Trace line width
+float g_linewidth       = 2.0f;
+
+// Capture History
+CaptureStore *g_capture = NULL;                     // Disk-backed history (live runs only)
+
+// Active filter cascade (response overlay, sweep reference)
+SOSSection g_response_sos[SOS_MAX_SECTIONS];
+int g_response_sections = 0;
+unsigned int g_response_version = 0;                // Changes with the coefficients
+
+// Live Trace Zoom
+int g_zoom = 0;                                     // Samples across the screen (0 = whole block)
+SincDisplay g_sinc;                                 // Band-limited points between samples
+std::vector<float> g_view_x;                        // Scene points of the live trace
+std::vector<float> g_view_y;
+
+/*
+ *  Name: void allocate_scope_buffers(int size)
+ *  Desc: (Re)allocates the display buffers for a new block size
+ */
+void allocate_scope_buffers(int size) {
+    delete [] g_buffer;
+    delete [] g_window;
+    delete [] g_display;
+
+    g_buffer_size = size;
+    g_buffer = new float[size];
+    g_window = new float[size];
+    g_display = new float[size];
+    memset(g_buffer, 0, sizeof(float)*size);
+    memset(g_window, 0, sizeof(float)*size);
+    memset(g_display, 0, sizeof(float)*size);
+}
+
+/*
+ *  Name: int zoomSamples()
+ *  Desc: Samples across the live trace, the whole block unless zoomed in
+ */
+int zoomSamples() {
+    return (g_zoom > 0 && g_zoom < g_buffer_size) ? g_zoom : g_buffer_size;
+}
+
+/*
+ *  Name: int traceColumns(int height)
+ *  Desc: Pixels across the trace (10 scene units seen by reshapeFunc's camera)
+ */
+int traceColumns(int height) {
+    return (int)(5.f*height/(10.f*tanf(22.5f*M_PI/180.f)));
+}
+
+/*
+ *  Name: int windowedTimeDomainPoints(float *buffer, int columns)
+ *  Desc: Scene points of the live trace into g_view_x/g_view_y, returns their
+ *        count. The g_zoom samples in the middle of the block are joined with
+ *        straight lines while they're dense. Once a sample spans
+ *        SINC_MIN_SPACING pixels the band-limited signal is evaluated at every
+ *        pixel column instead, so peaks between samples show.
+ */
+int windowedTimeDomainPoints(float *buffer, int columns) {
+    int visible = zoomSamples();
+    int first = (g_buffer_size - visible)/2;
+
+    // Initialize initial x
+    float x = -5;
+
+    if (columns < SINC_MIN_SPACING*visible) {
+        // Calculate increment x
+        float xinc = fabs((2*x)/visible);
+
+        g_view_x.resize(visible);
+        g_view_y.resize(visible);
+        for (int i = 0; i < visible; i++) {
+            g_view_x[i] = x;
+            g_view_y[i] = 4*buffer[first + i];
+            x += xinc;
+        }
+        return visible;
+    }
+
+    // One point per column, neighbours outside the view still shape the curve
+    g_view_x.resize(columns);
+    g_view_y.resize(columns);
+    g_sinc.render(buffer, g_buffer_size, first, (double)visible/columns, &g_view_y[0], columns);
+    for (int j = 0; j < columns; j++) {
+        g_view_x[j] = x + 10.f*j/columns;
+        g_view_y[j] *= 4;
+    }
+    return columns;
+}
+
+/*
+ *  Name: void rasterWindowedTimeDomain(Raster *r, float *buffer)
+ *  Desc: Software version of drawWindowedTimeDomain for headless frames: same
+ *        scene coordinates, projected as reshapeFunc's camera does, on a graticule
+ */
+void rasterWindowedTimeDomain(Raster *r, float *buffer) {
+    static std::vector<float> xs, ys;
+
+    // gluPerspective(45) from z = 10: scene units to pixels
+    float halfH = 10.f*tanf(22.5f*M_PI/180.f);
+    float halfW = halfH*r->getWidth()/r->getHeight();
+    float sx = 0.5f*r->getWidth()/halfW, sy = 0.5f*r->getHeight()/halfH;
+    float cx = 0.5f*r->getWidth(), cy = 0.5f*r->getHeight();
+
+    // White background, one division per scene unit
+    r->clear(RASTER_RGB(255, 255, 255));
+    r->drawGraticule((int)(cx - 5*sx), (int)(cy - 4*sy), (int)(cx + 5*sx), (int)(cy + 4*sy),
+            10, 8, RASTER_RGB(220, 220, 220), RASTER_RGB(160, 160, 160));
+
+    int n = windowedTimeDomainPoints(buffer, traceColumns(r->getHeight()));
+    xs.resize(n);
+    ys.resize(n);
+    for (int i = 0; i < n; i++) {
+        xs[i] = cx + g_view_x[i]*sx;
+        ys[i] = cy - g_view_y[i]*sy;
+    }
+
+    // Blue trace
+    r->drawPolyline(&xs[0], &ys[0], n, g_linewidth, RASTER_RGB(0, 0, 255));
+}
+
+/*
+ *  Name: void formatMeasurements(const Measurements *m, char *text, int size)
+ *  Desc: One line of readouts, shared by the GL view and headless renders
+ */
+void formatMeasurements(const Measurements *m, char *text, int size) {
+    snprintf(text, size, "RMS %.1f dBFS  Peak %.1f dBFS  DC %+.4f  Crest %.1f dB  "
+            "f(zc) %.2f Hz  f(ac) %.2f Hz  THD+N %.1f dB (%.3f%%)",
+            m->rms, m->peak, m->dc, m->crest, m->zcFreq, m->acFreq, m->thdn, 100.f*powf(10.f, m->thdn/20.f));
+}
+
+#endif  // SCOPE_VIEW_H